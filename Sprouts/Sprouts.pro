@@ -4,6 +4,19 @@ greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
 CONFIG += c++17
 
+# Optional decompressors for base64 encoded TMX layers.
+# Without zlib, zlib layers fall back to qUncompress and gzip layers are rejected.
+packagesExist(zlib) {
+    CONFIG += link_pkgconfig
+    PKGCONFIG += zlib
+    DEFINES += SPROUTS_HAVE_ZLIB
+}
+packagesExist(libzstd) {
+    CONFIG += link_pkgconfig
+    PKGCONFIG += libzstd
+    DEFINES += SPROUTS_HAVE_ZSTD
+}
+
 # You can make your code fail to compile if it uses deprecated APIs.
 # In order to do so, uncomment the following line.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
@@ -25,7 +38,21 @@ SOURCES += \
     transition.cpp \
     menu.cpp \
     introanimation.cpp \
-    endinganimation.cpp
+    endinganimation.cpp \
+    triggersystem.cpp \
+    tmxmap.cpp \
+    mapcache.cpp \
+    assetpreloader.cpp \
+    assetpack.cpp \
+    texturecache.cpp \
+    startupprofiler.cpp \
+    hotreloader.cpp \
+    entityregistry.cpp \
+    effectsystem.cpp \
+    animationclips.cpp \
+    timerwheel.cpp \
+    headlessrunner.cpp \
+    benchmarks.cpp
 
 HEADERS += \
     mainwindow.h \
@@ -44,7 +71,36 @@ HEADERS += \
     menu.h \
     level.h \
     introanimation.h \
-    endinganimation.h
+    endinganimation.h \
+    triggersystem.h \
+    tmxmap.h \
+    mapcache.h \
+    assetpreloader.h \
+    assetpack.h \
+    texturecache.h \
+    startupprofiler.h \
+    hotreloader.h \
+    entityregistry.h \
+    effectsystem.h \
+    animationclips.h \
+    spritepool.h \
+    timerwheel.h \
+    headlessrunner.h \
+    benchmarks.h
+
+# "make pack" builds assets.pack from the loose files in the source tree
+pack.target = pack
+PACK_ARGS = -platform offscreen --assets $$shell_quote($$PWD) --build-pack $$shell_quote($$PWD/assets.pack)
+win32 {
+    # debug_and_release (the default here) puts the executable in debug/ or
+    # release/; the Windows makefiles name that path $(DESTDIR_TARGET)
+    pack.depends = $(DESTDIR_TARGET)
+    pack.commands = $(DESTDIR_TARGET) $$PACK_ARGS
+} else {
+    pack.depends = $(TARGET)
+    pack.commands = $$OUT_PWD/$(TARGET) $$PACK_ARGS
+}
+QMAKE_EXTRA_TARGETS += pack
 
 FORMS += \
     mainwindow.ui
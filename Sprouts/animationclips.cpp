@@ -0,0 +1,26 @@
+#include "animationclips.h"
+#include "resourceloader.h"
+
+AnimationClips::AnimationClips(const QString& baseFolder, const QStringList& names)
+    : baseFolder(baseFolder), names(names), currentState(-1)
+{
+}
+
+const QVector<QPixmap>& AnimationClips::frames(int state)
+{
+    Q_ASSERT(state >= 0 && state < names.size());
+
+    if (state != currentState) {
+        // Drop the previous clip first so its pixmaps become evictable
+        currentFrames.clear();
+        currentFrames = ResourceLoader::importFolder(baseFolder + "/" + names[state]);
+        currentState = state;
+    }
+    return currentFrames;
+}
+
+void AnimationClips::reload()
+{
+    currentFrames.clear();
+    currentState = -1;
+}
\ No newline at end of file
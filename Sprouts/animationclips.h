@@ -0,0 +1,33 @@
+#ifndef ANIMATIONCLIPS_H
+#define ANIMATIONCLIPS_H
+
+#include <QPixmap>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// Animation clips indexed by a state enum. Each clip is a folder of frames
+// under one base folder, named by the state's entry in names. Only the clip
+// being shown is held; the others stay in the ResourceLoader cache, where
+// they can be evicted, and are fetched from it again on a state change.
+class AnimationClips
+{
+public:
+    AnimationClips(const QString& baseFolder, const QStringList& names);
+
+    // Frames for a state; empty if the folder has no images
+    const QVector<QPixmap>& frames(int state);
+
+    // Forget the held clip so it is read again (hot reload)
+    void reload();
+
+    int count() const { return names.size(); }
+
+private:
+    QString baseFolder;
+    QStringList names;
+    int currentState;
+    QVector<QPixmap> currentFrames;
+};
+
+#endif // ANIMATIONCLIPS_H
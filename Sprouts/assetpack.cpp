@@ -0,0 +1,255 @@
+#include "assetpack.h"
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+const char ASSET_PACK_MAGIC[4] = { 'S', 'P', 'A', 'K' };
+const int ASSET_PACK_ALIGNMENT = 16;
+
+struct AssetPackHeader {
+    char magic[4];
+    quint32 version;
+    quint32 entryCount;
+    quint32 reserved;
+    quint64 indexOffset;
+    quint64 pathsOffset;
+};
+
+qint64 alignUp(qint64 value)
+{
+    return (value + ASSET_PACK_ALIGNMENT - 1) / ASSET_PACK_ALIGNMENT * ASSET_PACK_ALIGNMENT;
+}
+
+}
+
+AssetPack::AssetPack()
+    : base(nullptr), fileSize(0), index(nullptr), entryCount(0), pathsOffset(0)
+{
+}
+
+AssetPack::~AssetPack()
+{
+    close();
+}
+
+quint64 AssetPack::hashPath(const QString& relativePath)
+{
+    // 64-bit FNV-1a over the UTF-8 path
+    QByteArray bytes = relativePath.toUtf8();
+    quint64 hash = 14695981039346656037ull;
+    for (char c : bytes) {
+        hash ^= static_cast<uchar>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+bool AssetPack::open(const QString& packPath)
+{
+    close();
+
+    file.setFileName(packPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    fileSize = file.size();
+    if (fileSize < qint64(sizeof(AssetPackHeader))) {
+        close();
+        return false;
+    }
+
+    const uchar* mapped = file.map(0, fileSize);
+    if (!mapped) {
+        qDebug() << "AssetPack: Failed to map" << packPath;
+        close();
+        return false;
+    }
+
+    AssetPackHeader header;
+    std::memcpy(&header, mapped, sizeof(header));
+    if (std::memcmp(header.magic, ASSET_PACK_MAGIC, sizeof(header.magic)) != 0
+        || header.version != ASSET_PACK_VERSION
+        || header.indexOffset + quint64(header.entryCount) * sizeof(Entry) > quint64(fileSize)
+        || header.pathsOffset > quint64(fileSize)) {
+        qDebug() << "AssetPack: Ignoring incompatible pack" << packPath;
+        close();
+        return false;
+    }
+
+    base = mapped;
+    index = reinterpret_cast<const Entry*>(mapped + header.indexOffset);
+    entryCount = header.entryCount;
+    pathsOffset = header.pathsOffset;
+    modified = QFileInfo(packPath).lastModified();
+
+    qDebug() << "AssetPack: Opened" << packPath << "with" << entryCount << "entries";
+    return true;
+}
+
+void AssetPack::close()
+{
+    if (file.isOpen()) {
+        file.close(); // Also unmaps
+    }
+    base = nullptr;
+    fileSize = 0;
+    index = nullptr;
+    entryCount = 0;
+    pathsOffset = 0;
+}
+
+QString AssetPack::entryPath(const Entry& entry) const
+{
+    return QString::fromUtf8(reinterpret_cast<const char*>(base + pathsOffset + entry.pathOffset), int(entry.pathSize));
+}
+
+const AssetPack::Entry* AssetPack::find(const QString& relativePath) const
+{
+    if (!base) {
+        return nullptr;
+    }
+
+    QString path = QDir::cleanPath(relativePath);
+    quint64 hash = hashPath(path);
+
+    const Entry* end = index + entryCount;
+    const Entry* it = std::lower_bound(index, end, hash, [](const Entry& entry, quint64 value) {
+        return entry.hash < value;
+    });
+
+    // Walk the (normally single) run of equal hashes to rule out collisions
+    for (; it != end && it->hash == hash; ++it) {
+        if (entryPath(*it) == path) {
+            return it;
+        }
+    }
+    return nullptr;
+}
+
+bool AssetPack::contains(const QString& relativePath) const
+{
+    return find(relativePath) != nullptr;
+}
+
+QByteArray AssetPack::data(const QString& relativePath) const
+{
+    const Entry* entry = find(relativePath);
+    if (!entry || entry->offset + entry->size > quint64(fileSize)) {
+        return QByteArray();
+    }
+    return QByteArray::fromRawData(reinterpret_cast<const char*>(base + entry->offset), int(entry->size));
+}
+
+qint64 AssetPack::size(const QString& relativePath) const
+{
+    const Entry* entry = find(relativePath);
+    return entry ? qint64(entry->size) : -1;
+}
+
+QStringList AssetPack::entries(const QString& directory, bool recursive) const
+{
+    QStringList result;
+    if (!base) {
+        return result;
+    }
+
+    QString prefix = QDir::cleanPath(directory) + "/";
+    for (quint32 i = 0; i < entryCount; ++i) {
+        QString path = entryPath(index[i]);
+        if (!path.startsWith(prefix)) continue;
+        if (!recursive && path.indexOf('/', prefix.size()) != -1) continue;
+        result.append(path);
+    }
+
+    result.sort();
+    return result;
+}
+
+bool AssetPack::build(const QString& rootDir, const QStringList& folders, const QString& packPath)
+{
+    QDir root(rootDir);
+
+    // Collect every file below the requested folders
+    QStringList paths;
+    for (const QString& folder : folders) {
+        QDirIterator it(root.absoluteFilePath(folder), QDir::Files, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            paths.append(QDir::cleanPath(root.relativeFilePath(it.next())));
+        }
+    }
+
+    std::sort(paths.begin(), paths.end(), [](const QString& a, const QString& b) {
+        quint64 hashA = hashPath(a);
+        quint64 hashB = hashPath(b);
+        return hashA != hashB ? hashA < hashB : a < b;
+    });
+
+    // Index and path table
+    QVector<Entry> entries(paths.size());
+    QByteArray pathTable;
+    for (int i = 0; i < paths.size(); ++i) {
+        QByteArray utf8 = paths[i].toUtf8();
+        entries[i].hash = hashPath(paths[i]);
+        entries[i].pathOffset = quint32(pathTable.size());
+        entries[i].pathSize = quint32(utf8.size());
+        pathTable.append(utf8);
+    }
+
+    AssetPackHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, ASSET_PACK_MAGIC, sizeof(header.magic));
+    header.version = ASSET_PACK_VERSION;
+    header.entryCount = quint32(entries.size());
+    header.indexOffset = quint64(alignUp(sizeof(header)));
+    header.pathsOffset = header.indexOffset + quint64(entries.size()) * sizeof(Entry);
+
+    // Asset bytes follow the path table, each on its own aligned offset
+    QVector<QByteArray> contents(paths.size());
+    qint64 offset = alignUp(qint64(header.pathsOffset) + pathTable.size());
+    for (int i = 0; i < paths.size(); ++i) {
+        QFile source(root.absoluteFilePath(paths[i]));
+        if (!source.open(QIODevice::ReadOnly)) {
+            qDebug() << "AssetPack: Failed to read" << paths[i];
+            return false;
+        }
+        contents[i] = source.readAll();
+        entries[i].offset = quint64(offset);
+        entries[i].size = quint64(contents[i].size());
+        offset = alignUp(offset + contents[i].size());
+    }
+
+    QSaveFile out(packPath);
+    if (!out.open(QIODevice::WriteOnly)) {
+        qDebug() << "AssetPack: Failed to create" << packPath;
+        return false;
+    }
+
+    auto pad = [&out]() {
+        qint64 padding = alignUp(out.pos()) - out.pos();
+        out.write(QByteArray(int(padding), '\0'));
+    };
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    pad();
+    out.write(reinterpret_cast<const char*>(entries.constData()), qint64(entries.size()) * qint64(sizeof(Entry)));
+    out.write(pathTable);
+    for (const QByteArray& content : contents) {
+        pad();
+        out.write(content);
+    }
+
+    if (!out.commit()) {
+        qDebug() << "AssetPack: Failed to write" << packPath;
+        return false;
+    }
+
+    qDebug() << "AssetPack: Packed" << paths.size() << "files into" << packPath << "(" << offset << "bytes)";
+    return true;
+}
\ No newline at end of file
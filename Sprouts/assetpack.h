@@ -0,0 +1,64 @@
+#ifndef ASSETPACK_H
+#define ASSETPACK_H
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QFile>
+#include <QString>
+#include <QStringList>
+
+// Bump whenever the on-disk layout changes
+const quint32 ASSET_PACK_VERSION = 1;
+
+// Read-only archive of game assets.
+//
+// Layout: a fixed header, an index of entries sorted by path hash, a table of
+// UTF-8 paths, then the asset bytes, each aligned to 16 bytes. The file is
+// mapped with QFile::map; lookups are a binary search over the index and
+// asset data is returned as views into the mapping.
+class AssetPack
+{
+public:
+    AssetPack();
+    ~AssetPack();
+
+    bool open(const QString& packPath);
+    void close();
+    bool isOpen() const { return base != nullptr; }
+
+    // Lookups by path relative to the asset root (e.g. "graphics/fruit/apple.png")
+    bool contains(const QString& relativePath) const;
+    QByteArray data(const QString& relativePath) const;
+    qint64 size(const QString& relativePath) const;
+    QDateTime lastModified() const { return modified; }
+
+    // Entries under a directory, sorted by path
+    QStringList entries(const QString& directory, bool recursive) const;
+
+    // Pack the given folders of rootDir into packPath
+    static bool build(const QString& rootDir, const QStringList& folders, const QString& packPath);
+
+    static quint64 hashPath(const QString& relativePath);
+
+private:
+    struct Entry {
+        quint64 hash;
+        quint64 offset;
+        quint64 size;
+        quint32 pathOffset;
+        quint32 pathSize;
+    };
+
+    QFile file;
+    const uchar* base;
+    qint64 fileSize;
+    const Entry* index;
+    quint32 entryCount;
+    quint64 pathsOffset;
+    QDateTime modified;
+
+    const Entry* find(const QString& relativePath) const;
+    QString entryPath(const Entry& entry) const;
+};
+
+#endif // ASSETPACK_H
@@ -0,0 +1,81 @@
+#include "assetpreloader.h"
+#include "resourceloader.h"
+#include "startupprofiler.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QPixmap>
+
+AssetPreloader::AssetPreloader(QObject *parent)
+    : QObject{parent}, completed(0), started(false), budgetReached(0), skipped(0)
+{
+}
+
+AssetPreloader::~AssetPreloader()
+{
+    // Results posted after this point are dropped along with this object
+    pool.clear();
+    pool.waitForDone();
+}
+
+void AssetPreloader::addImage(const QString& relativePath)
+{
+    queue.append(ResourceLoader::getResourcePath(relativePath));
+}
+
+void AssetPreloader::addDirectory(const QString& relativePath)
+{
+    queue.append(ResourceLoader::imageFiles(relativePath, true));
+}
+
+void AssetPreloader::start()
+{
+    started = true;
+    timer.start();
+    qDebug() << "AssetPreloader: Decoding" << queue.size() << "images on" << pool.maxThreadCount() << "threads";
+
+    if (queue.isEmpty()) {
+        emit finished();
+        return;
+    }
+
+    for (const QString& path : queue) {
+        pool.start([this, path]() {
+            // Still report back, so completion is counted, but don't decode
+            // what could not be kept
+            QImage image;
+            if (!budgetReached.loadAcquire()) {
+                image = ResourceLoader::decodeImage(path);
+            }
+            // Deliver on the GUI thread, where pixmaps may be created
+            QMetaObject::invokeMethod(this, [this, path, image]() {
+                imageDecoded(path, image);
+            }, Qt::QueuedConnection);
+        });
+    }
+}
+
+void AssetPreloader::imageDecoded(const QString& path, const QImage& image)
+{
+    if (!budgetReached.loadRelaxed()
+        && ResourceLoader::imageMemory() >= ResourceLoader::imageBudgetBytes()) {
+        budgetReached.storeRelease(1);
+    }
+
+    if (budgetReached.loadRelaxed()) {
+        skipped++;
+    } else if (image.isNull()) {
+        qDebug() << "AssetPreloader: Failed to decode" << path;
+    } else {
+        ResourceLoader::insertImage(path, QPixmap::fromImage(image));
+    }
+
+    completed++;
+    emit progress(completed, queue.size());
+
+    if (completed == queue.size()) {
+        qDebug() << "AssetPreloader: Finished decoding" << completed - skipped << "images,"
+                 << skipped << "skipped over the image budget";
+        StartupProfiler::record("Asset preload (worker threads)", timer.nsecsElapsed());
+        emit finished();
+    }
+}
\ No newline at end of file
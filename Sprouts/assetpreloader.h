@@ -0,0 +1,52 @@
+#ifndef ASSETPRELOADER_H
+#define ASSETPRELOADER_H
+
+#include <QObject>
+#include <QImage>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QThreadPool>
+#include <QAtomicInt>
+
+// Decodes images on worker threads and hands them to the ResourceLoader cache.
+// QImage decoding is thread-safe; the QPixmap conversion happens on the GUI
+// thread when each result is delivered. Once the cache reaches its image
+// budget the rest are skipped and load on first use instead.
+class AssetPreloader : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit AssetPreloader(QObject *parent = nullptr);
+    ~AssetPreloader();
+
+    // Queue work (paths relative to the asset root)
+    void addImage(const QString& relativePath);
+    void addDirectory(const QString& relativePath);
+
+    // Start decoding everything queued so far
+    void start();
+
+    bool isFinished() const { return started && completed == queue.size(); }
+    int completedCount() const { return completed; }
+    int totalCount() const { return queue.size(); }
+
+signals:
+    void progress(int completed, int total);
+    void finished();
+
+private:
+    QStringList queue; // Absolute paths
+    QThreadPool pool;
+    int completed;
+    bool started;
+    QElapsedTimer timer;
+    
+    // Set on the GUI thread when the cache is full; workers then skip decoding
+    QAtomicInt budgetReached;
+    int skipped;
+
+    void imageDecoded(const QString& path, const QImage& image);
+};
+
+#endif // ASSETPRELOADER_H
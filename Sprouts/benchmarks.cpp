@@ -0,0 +1,399 @@
+#include "benchmarks.h"
+#include "resourceloader.h"
+#include "tmxmap.h"
+#include "sprite.h"
+#include "spritegroup.h"
+#include "entityregistry.h"
+#include "effectsystem.h"
+#include "tree.h"
+#include "plant.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include <QXmlStreamReader>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+namespace {
+
+const int REPEATS = 5;
+
+// A field of /proc/self/status (VmRSS, VmHWM) in KiB, or -1 if unavailable.
+// /proc files report a size of 0, so read them whole instead of line by line.
+qint64 statusKiB(const QByteArray& field)
+{
+    QFile file("/proc/self/status");
+    if (!file.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+    const QList<QByteArray> lines = file.readAll().split('\n');
+    for (const QByteArray& line : lines) {
+        if (line.startsWith(field + ':')) {
+            return line.mid(field.size() + 1).simplified().split(' ').value(0).toLongLong();
+        }
+    }
+    return -1;
+}
+
+// Reset the peak (VmHWM) to the current resident size, so the next reading
+// belongs to the code that runs in between
+void resetPeakMemory()
+{
+    QFile file("/proc/self/clear_refs");
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write("5");
+    }
+}
+
+// Peak memory above the resident size at the last resetPeakMemory()
+struct PeakMeter
+{
+    qint64 baseline;
+
+    PeakMeter() { resetPeakMemory(); baseline = statusKiB("VmRSS"); }
+    qint64 peakKiB() const
+    {
+        qint64 peak = statusKiB("VmHWM");
+        return peak < 0 || baseline < 0 ? -1 : peak - baseline;
+    }
+};
+
+// Bytes currently allocated on the heap, or -1 where the C library can't say
+qint64 heapBytes()
+{
+    // __GLIBC_PREREQ only exists with glibc, so it can't share an #if with
+    // the defined() check
+#if defined(__GLIBC__)
+#if __GLIBC_PREREQ(2, 33)
+    return qint64(mallinfo2().uordblks);
+#else
+    return -1;
+#endif
+#else
+    return -1;
+#endif
+}
+
+QString ms(qint64 nsecs)
+{
+    return QString::number(nsecs / 1e6, 'f', 2) + " ms";
+}
+
+// The decoder TmxMap used before the streaming one, kept as the baseline:
+// every layer's text is split into lines, then values, then converted.
+int legacyDecode(const QByteArray& contents, QVector<QByteArray>& layers)
+{
+    QXmlStreamReader xml(contents);
+    int width = 0;
+    int height = 0;
+
+    while (!xml.atEnd() && !xml.hasError()) {
+        if (xml.readNext() != QXmlStreamReader::StartElement) {
+            continue;
+        }
+        if (xml.name() == QLatin1String("layer")) {
+            width = xml.attributes().value("width").toInt();
+            height = xml.attributes().value("height").toInt();
+        } else if (xml.name() == QLatin1String("data")) {
+            QByteArray tiles(width * height * int(sizeof(quint16)), 0);
+            quint16* out = reinterpret_cast<quint16*>(tiles.data());
+            int index = 0;
+
+            QString data = xml.readElementText();
+            QStringList lines = data.split('\n');
+            for (const QString& line : lines) {
+                if (line.trimmed().isEmpty()) continue;
+                QStringList values = line.split(',');
+                for (const QString& value : values) {
+                    if (value.trimmed().isEmpty()) continue;
+                    if (index < width * height) {
+                        out[index] = static_cast<quint16>(value.trimmed().toInt());
+                    }
+                    ++index;
+                }
+            }
+            layers.append(tiles);
+        }
+    }
+    return xml.hasError() ? -1 : layers.size();
+}
+
+// A world sprite as it was while Sprite derived from QObject: the same
+// fields plus a QObject parented to its owner
+class QObjectGeneric : public QObject, public Generic
+{
+public:
+    QObjectGeneric(const QPoint& pos, const QPixmap& surf, const QVector<SpriteGroup*>& groups, QObject* parent)
+        : QObject(parent), Generic(pos, surf, groups)
+    {
+    }
+};
+
+} // namespace
+
+QStringList Benchmarks::names()
+{
+    return QStringList() << "map-csv" << "entities" << "typed-queries";
+}
+
+int Benchmarks::run(const QString& name, int size)
+{
+    if (name == "map-csv") {
+        return mapParse(size > 0 ? size : 500);
+    }
+    if (name == "entities") {
+        return entities(size > 0 ? size : 10000);
+    }
+    if (name == "typed-queries") {
+        return typedQueries(size > 0 ? size : 5000);
+    }
+
+    qDebug() << "Benchmarks: Unknown benchmark" << name << "- available:" << names().join(", ");
+    return 1;
+}
+
+int Benchmarks::mapParse(int size)
+{
+    // Same shape as data/map.tmx: a handful of CSV tile layers, mostly
+    // small gids with some empty tiles
+    const int layerCount = 6;
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        qDebug() << "Benchmarks: Can't create a temporary directory";
+        return 1;
+    }
+
+    QByteArray xml;
+    xml += "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+    xml += QString("<map version=\"1.10\" orientation=\"orthogonal\" width=\"%1\" height=\"%1\" "
+                   "tilewidth=\"64\" tileheight=\"64\">\n").arg(size).toUtf8();
+    QRandomGenerator random(1);
+    for (int l = 0; l < layerCount; ++l) {
+        xml += QString(" <layer id=\"%1\" name=\"Layer%1\" width=\"%2\" height=\"%2\">\n"
+                       "  <data encoding=\"csv\">\n").arg(l + 1).arg(size).toUtf8();
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                int gid = random.bounded(4) == 0 ? 0 : random.bounded(1, 700);
+                xml += QByteArray::number(gid);
+                if (x < size - 1 || y < size - 1) {
+                    xml += ',';
+                }
+            }
+            xml += '\n';
+        }
+        xml += "</data>\n </layer>\n";
+    }
+    xml += "</map>\n";
+
+    QFile file(dir.filePath("bench.tmx"));
+    if (!file.open(QIODevice::WriteOnly) || file.write(xml) != xml.size()) {
+        qDebug() << "Benchmarks: Can't write" << file.fileName();
+        return 1;
+    }
+    file.close();
+    ResourceLoader::setAssetRoot(dir.path());
+
+    qDebug().noquote() << QString("Benchmarks: map-csv, %1x%1 tiles, %2 layers, %3 KiB of XML")
+                          .arg(size).arg(layerCount).arg(xml.size() / 1024);
+
+    // Both decoders read the file the same way; best of REPEATS for time,
+    // peak memory from the first run
+    qint64 legacyBest = -1;
+    qint64 legacyPeak = -1;
+    for (int i = 0; i < REPEATS; ++i) {
+        PeakMeter meter;
+        QElapsedTimer timer;
+        timer.start();
+        QVector<QByteArray> layers;
+        if (legacyDecode(ResourceLoader::readFile("bench.tmx"), layers) != layerCount) {
+            qDebug() << "Benchmarks: Legacy decoder failed";
+            return 1;
+        }
+        qint64 nsecs = timer.nsecsElapsed();
+        legacyBest = legacyBest < 0 ? nsecs : qMin(legacyBest, nsecs);
+        if (i == 0) legacyPeak = meter.peakKiB();
+    }
+
+    qint64 streamingBest = -1;
+    qint64 streamingPeak = -1;
+    for (int i = 0; i < REPEATS; ++i) {
+        PeakMeter meter;
+        QElapsedTimer timer;
+        timer.start();
+        TmxMap map;
+        if (!map.loadXml("bench.tmx") || map.layers.size() != layerCount) {
+            qDebug() << "Benchmarks: TmxMap failed to parse the generated map";
+            return 1;
+        }
+        qint64 nsecs = timer.nsecsElapsed();
+        streamingBest = streamingBest < 0 ? nsecs : qMin(streamingBest, nsecs);
+        if (i == 0) streamingPeak = meter.peakKiB();
+    }
+
+    qDebug().noquote() << QString("  split/toInt decoder: %1, peak +%2 KiB").arg(ms(legacyBest)).arg(legacyPeak);
+    qDebug().noquote() << QString("  streaming decoder:   %1, peak +%2 KiB").arg(ms(streamingBest)).arg(streamingPeak);
+    return 0;
+}
+
+int Benchmarks::entities(int count)
+{
+    // One shared image, as tiles of the same kind share theirs
+    QPixmap surf(TILE_SIZE, TILE_SIZE);
+    surf.fill(Qt::darkGray);
+    SpriteGroup group;
+    QVector<SpriteGroup*> groups;
+    groups.append(&group);
+
+    qDebug().noquote() << QString("Benchmarks: entities, %1 sprites, sizeof(Generic) %2, sizeof(QObject) %3")
+                          .arg(count).arg(sizeof(Generic)).arg(sizeof(QObject));
+
+    qint64 plainBuild = -1, plainFree = -1, plainBytes = -1;
+    qint64 objectBuild = -1, objectFree = -1, objectBytes = -1;
+    for (int i = 0; i < REPEATS; ++i) {
+        // Current layout: plain sprites owned by an EntityRegistry
+        {
+            EntityRegistry registry;
+            qint64 heapBefore = heapBytes();
+            QElapsedTimer timer;
+            timer.start();
+            for (int n = 0; n < count; ++n) {
+                registry.adopt(new Generic(QPoint(n % 500, n / 500) * TILE_SIZE, surf, groups, SOIL));
+            }
+            qint64 build = timer.nsecsElapsed();
+            qint64 bytes = heapBefore < 0 ? -1 : heapBytes() - heapBefore;
+
+            timer.restart();
+            group.clear();
+            registry.flush();
+            qint64 release = timer.nsecsElapsed();
+
+            plainBuild = plainBuild < 0 ? build : qMin(plainBuild, build);
+            plainFree = plainFree < 0 ? release : qMin(plainFree, release);
+            plainBytes = bytes;
+        }
+
+        // Previous layout: every sprite also a QObject child of its owner
+        {
+            QObject* owner = new QObject;
+            qint64 heapBefore = heapBytes();
+            QElapsedTimer timer;
+            timer.start();
+            for (int n = 0; n < count; ++n) {
+                new QObjectGeneric(QPoint(n % 500, n / 500) * TILE_SIZE, surf, groups, owner);
+            }
+            qint64 build = timer.nsecsElapsed();
+            qint64 bytes = heapBefore < 0 ? -1 : heapBytes() - heapBefore;
+
+            timer.restart();
+            delete owner;
+            qint64 release = timer.nsecsElapsed();
+
+            objectBuild = objectBuild < 0 ? build : qMin(objectBuild, build);
+            objectFree = objectFree < 0 ? release : qMin(objectFree, release);
+            objectBytes = bytes;
+        }
+    }
+
+    auto perEntity = [count](qint64 bytes) {
+        return bytes < 0 ? QString("n/a") : QString::number(double(bytes) / count, 'f', 1) + " B";
+    };
+    qDebug().noquote() << QString("  plain Sprite:   build %1, free %2, heap %3/entity")
+                          .arg(ms(plainBuild)).arg(ms(plainFree)).arg(perEntity(plainBytes));
+    qDebug().noquote() << QString("  QObject Sprite: build %1, free %2, heap %3/entity")
+                          .arg(ms(objectBuild)).arg(ms(objectFree)).arg(perEntity(objectBytes));
+    return 0;
+}
+
+int Benchmarks::typedQueries(int count)
+{
+    const int queries = 1000;
+
+    // Declared in this order so the registry frees the sprites while their
+    // groups and the effect system are still alive
+    EffectSystem effects;
+    SpriteGroup allSprites;
+    TypedGroup<Tree> treeSprites;
+    TypedGroup<Plant> plantSprites;
+    EntityRegistry registry;
+
+    QPixmap treeSurf = ResourceLoader::loadImage("graphics/objects/tree_small.png");
+    if (treeSurf.isNull()) {
+        qDebug() << "Benchmarks: typed-queries needs the game assets (see --assets)";
+        return 1;
+    }
+
+    QVector<SpriteGroup*> treeGroups;
+    treeGroups << &allSprites << &treeSprites;
+    QVector<SpriteGroup*> plantGroups;
+    plantGroups << &plantSprites << &allSprites;
+
+    for (int n = 0; n < count; ++n) {
+        QPoint pos(n % 100 * TILE_SIZE * 2, n / 100 * TILE_SIZE * 2);
+        registry.adopt(new Tree(pos, treeSurf, treeGroups, "Small", [](const QString&) {}, &effects));
+
+        Plant* plant = registry.adopt(new Plant("corn", plantGroups, SpriteHandle(), &registry,
+                                                [](const QPointF&) { return false; }));
+        plant->rect = QRect(pos + QPoint(TILE_SIZE, 0), plant->image.size());
+    }
+
+    qDebug().noquote() << QString("Benchmarks: typed-queries, %1 trees, %2 plants, %3 sprites in the world group")
+                          .arg(treeSprites.size()).arg(plantSprites.size()).arg(allSprites.size());
+
+    // Worst case for both paths: nothing is hit, so every member is visited
+    const QPoint target(-TILE_SIZE, -TILE_SIZE);
+    const QRect hitbox(-TILE_SIZE, -TILE_SIZE, 40, 16);
+    int hits = 0;
+
+    auto timeQueries = [&](const std::function<void()>& query) {
+        qint64 best = -1;
+        for (int i = 0; i < REPEATS; ++i) {
+            QElapsedTimer timer;
+            timer.start();
+            for (int q = 0; q < queries; ++q) {
+                query();
+            }
+            qint64 nsecs = timer.nsecsElapsed();
+            best = best < 0 ? nsecs : qMin(best, nsecs);
+        }
+        return QString::number(double(best) / queries / 1000.0, 'f', 2) + " us/query";
+    };
+
+    // Before: a copy of the member list and a cast per element. qobject_cast
+    // is gone along with QObject in Sprite, so dynamic_cast stands in for it.
+    QString axeCast = timeQueries([&]() {
+        for (Sprite* sprite : treeSprites.sprites()) {
+            if (Tree* tree = dynamic_cast<Tree*>(sprite)) {
+                if (tree->rect.contains(target)) { ++hits; break; }
+            }
+        }
+    });
+    QString harvestCast = timeQueries([&]() {
+        for (Sprite* sprite : plantSprites.sprites()) {
+            if (Plant* plant = dynamic_cast<Plant*>(sprite)) {
+                if (plant->harvestable && plant->rect.intersects(hitbox)) { ++hits; break; }
+            }
+        }
+    });
+
+    // Now: straight over the typed groups, as Player::useTool and
+    // Level::plantCollision do
+    QString axeTyped = timeQueries([&]() {
+        for (Tree* tree : treeSprites) {
+            if (tree->rect.contains(target)) { ++hits; break; }
+        }
+    });
+    QString harvestTyped = timeQueries([&]() {
+        for (Plant* plant : plantSprites) {
+            if (plant->harvestable && plant->rect.intersects(hitbox)) { ++hits; break; }
+        }
+    });
+
+    qDebug().noquote() << QString("  axe hit test: cast %1, typed %2").arg(axeCast, axeTyped);
+    qDebug().noquote() << QString("  harvest scan: cast %1, typed %2").arg(harvestCast, harvestTyped);
+    qDebug() << "  hits:" << hits; // keeps the loops from being optimised away; 0 expected
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+#include <QString>
+#include <QStringList>
+
+// Micro-benchmarks run instead of the game (--headless --bench <name>). Each
+// prints wall time and resident memory figures through qDebug; memory is
+// read from /proc, so those figures are only available on Linux.
+class Benchmarks
+{
+public:
+    static QStringList names();
+
+    // Run one benchmark; size is its problem size (0 = the benchmark's
+    // default). Returns the process exit code.
+    static int run(const QString& name, int size);
+
+private:
+    // CSV tile decoding on a generated size x size map: the streaming decoder
+    // in TmxMap against the old readElementText/split/toInt decoder
+    static int mapParse(int size);
+
+    // Construction, heap footprint and destruction of count world sprites,
+    // against the same sprites carrying a QObject as they did before
+    static int entities(int count);
+
+    // The axe hit test (Player::useTool) and harvest scan (Level::plantCollision)
+    // over count trees and count plants: typed groups against a cast per element
+    static int typedQueries(int count);
+};
+
+#endif // BENCHMARKS_H
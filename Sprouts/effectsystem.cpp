@@ -0,0 +1,81 @@
+#include "effectsystem.h"
+#include <QImage>
+
+void EffectSystem::flash(const QPoint& pos, const QPixmap& source, int durationMs, const QColor& tint)
+{
+    if (source.isNull()) {
+        return;
+    }
+
+    Effect effect;
+    effect.x = pos.x();
+    effect.y = pos.y();
+    effect.age = 0.0f;
+    effect.duration = durationMs / 1000.0f;
+    effect.mask = maskFor(source, tint);
+    effects.append(effect);
+}
+
+void EffectSystem::update(float dt)
+{
+    int kept = 0;
+    for (int i = 0; i < effects.size(); ++i) {
+        Effect& effect = effects[i];
+        effect.age += dt;
+        if (effect.age < effect.duration) {
+            effects[kept++] = effect;
+        }
+    }
+    effects.resize(kept);
+}
+
+void EffectSystem::draw(QPainter& painter, const QPointF& offset) const
+{
+    for (const Effect& effect : effects) {
+        painter.drawPixmap(QPointF(effect.x - offset.x(), effect.y - offset.y()), masks[effect.mask]);
+    }
+}
+
+void EffectSystem::pruneMasks()
+{
+    QVector<int> remap(masks.size(), -1);
+    QVector<QPixmap> keptMasks;
+    QVector<QPair<qint64, QRgb>> keptKeys;
+    maskIndex.clear();
+
+    for (Effect& effect : effects) {
+        if (remap[effect.mask] < 0) {
+            remap[effect.mask] = keptMasks.size();
+            keptMasks.append(masks[effect.mask]);
+            keptKeys.append(maskKeys[effect.mask]);
+            maskIndex.insert(maskKeys[effect.mask], remap[effect.mask]);
+        }
+        effect.mask = remap[effect.mask];
+    }
+
+    masks = keptMasks;
+    maskKeys = keptKeys;
+}
+
+int EffectSystem::maskFor(const QPixmap& source, const QColor& tint)
+{
+    // Keyed by pixmap identity, so a reloaded image gets a fresh mask and
+    // the old one stays until pruneMasks()
+    QPair<qint64, QRgb> key = qMakePair(source.cacheKey(), tint.rgba());
+    auto it = maskIndex.constFind(key);
+    if (it != maskIndex.constEnd()) {
+        return it.value();
+    }
+
+    // Keep the source's alpha and replace its colour with the tint
+    QImage mask = source.toImage().convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    QPainter painter(&mask);
+    painter.setCompositionMode(QPainter::CompositionMode_SourceIn);
+    painter.fillRect(mask.rect(), tint);
+    painter.end();
+
+    masks.append(QPixmap::fromImage(mask));
+    maskKeys.append(key);
+    maskIndex.insert(key, masks.size() - 1);
+    return masks.size() - 1;
+}
\ No newline at end of file
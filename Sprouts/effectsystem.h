@@ -0,0 +1,60 @@
+#ifndef EFFECTSYSTEM_H
+#define EFFECTSYSTEM_H
+
+#include <QColor>
+#include <QHash>
+#include <QPainter>
+#include <QPair>
+#include <QPixmap>
+#include <QPoint>
+#include <QPointF>
+#include <QVector>
+
+// Short-lived visual effects (harvest and tree-chop flashes). Effects are
+// plain records advanced by game time, so they stop with the game while the
+// shop or an animation is up, and the silhouette each one shows is built once
+// per source image and tint and then shared.
+class EffectSystem
+{
+public:
+    EffectSystem() = default;
+
+    EffectSystem(const EffectSystem&) = delete;
+    EffectSystem& operator=(const EffectSystem&) = delete;
+
+    // Show the silhouette of an image, filled with a tint, for a while
+    void flash(const QPoint& pos, const QPixmap& source, int durationMs = 200,
+               const QColor& tint = QColor(255, 255, 255));
+
+    // Advance by game time and drop finished effects
+    void update(float dt);
+
+    // Draw in world coordinates; offset is the camera offset
+    void draw(QPainter& painter, const QPointF& offset) const;
+
+    // Drop masks no running effect shows. Masks are keyed by pixmap identity,
+    // so reloaded or regrown images would otherwise leave theirs behind.
+    void pruneMasks();
+
+    void clear() { effects.clear(); }
+    int size() const { return effects.size(); }
+    int cachedMasks() const { return masks.size(); }
+
+private:
+    struct Effect {
+        float x;
+        float y;
+        float age;
+        float duration;
+        int mask;
+    };
+
+    int maskFor(const QPixmap& source, const QColor& tint);
+
+    QVector<Effect> effects;
+    QVector<QPixmap> masks;
+    QVector<QPair<qint64, QRgb>> maskKeys;
+    QHash<QPair<qint64, QRgb>, int> maskIndex;
+};
+
+#endif // EFFECTSYSTEM_H
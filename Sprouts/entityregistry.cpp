@@ -0,0 +1,93 @@
+#include "entityregistry.h"
+#include "sprite.h"
+
+EntityRegistry::~EntityRegistry()
+{
+    // Detach first so sprites dying here don't queue themselves
+    for (Slot& slot : entries) {
+        if (slot.sprite) {
+            slot.sprite->registry = nullptr;
+        }
+    }
+    for (Slot& slot : entries) {
+        delete slot.sprite;
+        slot.sprite = nullptr;
+    }
+}
+
+void EntityRegistry::add(Sprite* sprite)
+{
+    Q_ASSERT_X(!sprite->registry, "EntityRegistry::add", "sprite is already registered");
+
+    quint32 index;
+    if (!freeSlots.isEmpty()) {
+        index = freeSlots.takeLast();
+    } else {
+        index = entries.size();
+        entries.append(Slot());
+    }
+
+    Slot& slot = entries[index];
+    slot.sprite = sprite;
+    slot.queued = false;
+    liveCount++;
+
+    sprite->registry = this;
+    sprite->registryHandle.index = index;
+    sprite->registryHandle.generation = slot.generation;
+
+    // Killed before it was adopted (e.g. nothing to draw); still ours to free
+    if (!sprite->alive) {
+        destroyLater(sprite->registryHandle);
+    }
+}
+
+Sprite* EntityRegistry::get(SpriteHandle handle) const
+{
+    if (handle.isNull() || handle.index >= quint32(entries.size())) {
+        return nullptr;
+    }
+    const Slot& slot = entries[handle.index];
+    return slot.generation == handle.generation ? slot.sprite : nullptr;
+}
+
+void EntityRegistry::destroyLater(SpriteHandle handle)
+{
+    Q_ASSERT_X(get(handle), "EntityRegistry::destroyLater", "stale sprite handle");
+    if (!get(handle)) {
+        return;
+    }
+
+    Slot& slot = entries[handle.index];
+    if (!slot.queued) {
+        slot.queued = true;
+        destroyQueue.append(handle.index);
+    }
+}
+
+void EntityRegistry::flush()
+{
+    // Destructors can kill other registered sprites; keep going until empty
+    while (!destroyQueue.isEmpty()) {
+        QVector<quint32> queue;
+        queue.swap(destroyQueue);
+
+        for (quint32 index : queue) {
+            Slot& slot = entries[index];
+            Sprite* sprite = slot.sprite;
+
+            // Invalidate outstanding handles before the slot can be reused
+            slot.sprite = nullptr;
+            slot.queued = false;
+            slot.generation++;
+            if (slot.generation == 0) {
+                slot.generation = 1;
+            }
+            freeSlots.append(index);
+            liveCount--;
+
+            sprite->registry = nullptr;
+            delete sprite;
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,70 @@
+#ifndef ENTITYREGISTRY_H
+#define ENTITYREGISTRY_H
+
+#include <QVector>
+#include <QtGlobal>
+
+class Sprite;
+
+// Weak reference to a sprite in an EntityRegistry. The generation changes
+// whenever a slot is reused, so a handle to a destroyed sprite never resolves
+// to whatever took its place. A default constructed handle is null.
+struct SpriteHandle
+{
+    quint32 index = 0;
+    quint32 generation = 0;
+
+    bool isNull() const { return generation == 0; }
+    bool operator==(const SpriteHandle& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const SpriteHandle& other) const { return !(*this == other); }
+};
+
+// Owns world sprites. Killing a registered sprite queues it for destruction,
+// and flush() frees the queue between frames, so pointers taken during a
+// frame stay valid until it ends. Anything that keeps a sprite across frames
+// should hold a SpriteHandle instead of a Sprite*.
+class EntityRegistry
+{
+public:
+    EntityRegistry() = default;
+    ~EntityRegistry();
+
+    EntityRegistry(const EntityRegistry&) = delete;
+    EntityRegistry& operator=(const EntityRegistry&) = delete;
+
+    template<class T>
+    T* adopt(T* sprite)
+    {
+        add(sprite);
+        return sprite;
+    }
+
+    // The sprite for a handle, or nullptr if it has been destroyed
+    Sprite* get(SpriteHandle handle) const;
+    bool isAlive(SpriteHandle handle) const { return get(handle) != nullptr; }
+
+    // Queue a sprite for destruction at the next flush()
+    void destroyLater(SpriteHandle handle);
+
+    // Free every queued sprite; called once per frame
+    void flush();
+
+    int size() const { return liveCount; }
+    int pending() const { return destroyQueue.size(); }
+
+private:
+    struct Slot {
+        Sprite* sprite = nullptr;
+        quint32 generation = 1;
+        bool queued = false;
+    };
+
+    void add(Sprite* sprite);
+
+    QVector<Slot> entries;
+    QVector<quint32> freeSlots;
+    QVector<quint32> destroyQueue;
+    int liveCount = 0;
+};
+
+#endif // ENTITYREGISTRY_H
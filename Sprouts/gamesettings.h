@@ -6,6 +6,7 @@
 #include <QMap>
 #include <QVector>
 #include <QString>
+#include <QStringList>
 
 // Screen constants
 const int SCREEN_WIDTH = 1280;
@@ -34,6 +35,7 @@ enum ToolType {
     AXE,
     WATER_TOOL
 };
+const int TOOL_COUNT = WATER_TOOL + 1;
 
 // Seed types
 enum SeedType {
@@ -65,16 +67,58 @@ enum PlayerStatus {
     RIGHT_WATER
 };
 
+// PlayerStatus is laid out as action * 4 + direction
+enum Direction {
+    DIRECTION_UP,
+    DIRECTION_DOWN,
+    DIRECTION_LEFT,
+    DIRECTION_RIGHT
+};
+
+enum PlayerAction {
+    ACTION_MOVE,
+    ACTION_IDLE,
+    ACTION_HOE,
+    ACTION_AXE,
+    ACTION_WATER
+};
+
+const int PLAYER_STATUS_COUNT = RIGHT_WATER + 1;
+
+inline PlayerStatus playerStatus(Direction direction, PlayerAction action)
+{
+    return PlayerStatus(int(action) * 4 + int(direction));
+}
+
+inline Direction statusDirection(PlayerStatus status)
+{
+    return Direction(int(status) % 4);
+}
+
+inline PlayerAction toolAction(ToolType tool)
+{
+    return PlayerAction(ACTION_HOE + int(tool));
+}
+
+// Folders under graphics/character, indexed by PlayerStatus
+const QStringList PLAYER_STATUS_NAMES = {
+    "up", "down", "left", "right",
+    "up_idle", "down_idle", "left_idle", "right_idle",
+    "up_hoe", "down_hoe", "left_hoe", "right_hoe",
+    "up_axe", "down_axe", "left_axe", "right_axe",
+    "up_water", "down_water", "left_water", "right_water"
+};
+
 // Overlay positions
 const QPoint TOOL_OVERLAY_POS(40, SCREEN_HEIGHT - 15);
 const QPoint SEED_OVERLAY_POS(70, SCREEN_HEIGHT - 5);
 
-// Player tool offsets
-const QMap<QString, QPointF> PLAYER_TOOL_OFFSET = {
-    {"left", QPointF(-50, 40)},
-    {"right", QPointF(50, 40)},
-    {"up", QPointF(0, -10)},
-    {"down", QPointF(0, 50)}
+// Player tool offsets, indexed by Direction
+const QPointF PLAYER_TOOL_OFFSET[] = {
+    QPointF(0, -10),  // up
+    QPointF(0, 50),   // down
+    QPointF(-50, 40), // left
+    QPointF(50, 40)   // right
 };
 
 // Apple positions for different tree sizes
@@ -83,6 +127,18 @@ const QMap<QString, QVector<QPoint>> APPLE_POS = {
     {"Large", {{30,24}, {60,65}, {50,50}, {16,40}, {45,50}, {42,70}}}
 };
 
+// Special tile ids in the TMX map
+const int COLLISION_TILE_ID = 170;
+const int FARMABLE_TILE_ID = 169;
+
+// Rain drops are only simulated this far outside the screen
+const int RAIN_MARGIN = 128;
+
+// Fixed simulation rate (steps per second, see --tick-rate) and how many
+// steps a single frame may run to catch up before the backlog is dropped
+const int DEFAULT_STEP_RATE = 60;
+const int MAX_CATCH_UP_STEPS = 5;
+
 // Growth speeds
 const QMap<QString, float> GROW_SPEED = {
     {"corn", 1.0f},
@@ -1,39 +1,33 @@
 #include "gametimer.h"
 
-GameTimer::GameTimer(int duration, std::function<void()> callback, QObject *parent)
-    : QObject{parent}, duration(duration), active(false), callback(callback)
+GameTimer::GameTimer(TimerWheel* wheel, int duration, std::function<void()> callback)
 {
-    timer = new QTimer(this);
-    timer->setSingleShot(true);
-    connect(timer, &QTimer::timeout, this, &GameTimer::onTimeout);
+    setup(wheel, duration, callback);
 }
 
-void GameTimer::activate()
+GameTimer::~GameTimer()
 {
-    if (!active) {
-        active = true;
-        timer->start(duration);
-    }
+    deactivate();
 }
 
-void GameTimer::deactivate()
+void GameTimer::setup(TimerWheel* wheel, int duration, std::function<void()> callback)
 {
-    if (active) {
-        active = false;
-        timer->stop();
-    }
+    deactivate();
+    this->wheel = wheel;
+    this->duration = duration;
+    this->callback = callback;
 }
 
-void GameTimer::update()
+void GameTimer::activate()
 {
-    // This method can be used for manual timer updates if needed
-    // Currently, Qt's QTimer handles the timing automatically
+    if (wheel && !isActive()) {
+        handle = wheel->schedule(duration, callback);
+    }
 }
 
-void GameTimer::onTimeout()
+void GameTimer::deactivate()
 {
-    active = false;
-    if (callback) {
-        callback();
+    if (isActive()) {
+        wheel->cancel(handle);
     }
 }
\ No newline at end of file
@@ -1,34 +1,36 @@
 #ifndef GAMETIMER_H
 #define GAMETIMER_H
 
-#include <QObject>
-#include <QTimer>
 #include <functional>
+#include "timerwheel.h"
 
-class GameTimer : public QObject
+// Cooldown on the level's TimerWheel: active from activate() until its
+// duration of game time has passed, then runs the optional callback.
+class GameTimer
 {
-    Q_OBJECT
-
 public:
-    explicit GameTimer(int duration, std::function<void()> callback = nullptr, QObject *parent = nullptr);
+    GameTimer() = default;
+    GameTimer(TimerWheel* wheel, int duration, std::function<void()> callback = nullptr);
+    ~GameTimer();
+    
+    GameTimer(const GameTimer&) = delete;
+    GameTimer& operator=(const GameTimer&) = delete;
+    
+    void setup(TimerWheel* wheel, int duration, std::function<void()> callback = nullptr);
     
     // Timer control
     void activate();
     void deactivate();
-    void update();
     
     // Properties
-    bool isActive() const { return active; }
+    bool isActive() const { return wheel && wheel->isPending(handle); }
     int getDuration() const { return duration; }
     void setDuration(int newDuration) { duration = newDuration; }
     
-private slots:
-    void onTimeout();
-    
 private:
-    QTimer* timer;
-    int duration; // in milliseconds
-    bool active;
+    TimerWheel* wheel = nullptr;
+    TimerHandle handle;
+    int duration = 0; // in milliseconds
     std::function<void()> callback;
 };
 
@@ -0,0 +1,105 @@
+#include "headlessrunner.h"
+#include "level.h"
+#include "player.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QMetaEnum>
+#include <QStringList>
+#include <QDebug>
+#include <algorithm>
+
+bool HeadlessRunner::loadScript(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        qDebug() << "HeadlessRunner: Can't read script" << path << file.errorString();
+        return false;
+    }
+    QByteArray data = file.readAll();
+
+    const QMetaEnum keys = QMetaEnum::fromType<Qt::Key>();
+    const QStringList lines = QString::fromUtf8(data).split('\n');
+    for (int i = 0; i < lines.size(); ++i) {
+        QString line = lines[i].trimmed();
+        if (line.isEmpty() || line.startsWith('#')) {
+            continue;
+        }
+
+        QStringList fields = line.split(' ', Qt::SkipEmptyParts);
+        bool tickOk = false;
+        ScriptEvent event;
+        event.tick = fields.size() == 3 ? fields[0].toInt(&tickOk) : -1;
+        event.pressed = fields.value(1) == "press";
+        bool keyOk = false;
+        event.key = keys.keyToValue(QString("Key_" + fields.value(2)).toLatin1().constData(), &keyOk);
+
+        if (!tickOk || event.tick < 0 || !keyOk || (!event.pressed && fields[1] != "release")) {
+            qDebug() << "HeadlessRunner:" << path << "line" << i + 1 << "is not \"<tick> press|release <key>\":" << line;
+            return false;
+        }
+        events.append(event);
+    }
+
+    // Stable, so events on the same tick keep their order
+    std::stable_sort(events.begin(), events.end(),
+                     [](const ScriptEvent& a, const ScriptEvent& b) { return a.tick < b.tick; });
+
+    qDebug() << "HeadlessRunner: Loaded" << events.size() << "input events from" << path;
+    return true;
+}
+
+int HeadlessRunner::run(int ticks)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // Nobody is listening, and audio startup would skew the timings
+    Level::setMusicEnabled(false);
+    Level level;
+
+    // Assets are decoded on worker threads; the world is built when they finish
+    while (!level.isLoaded()) {
+        QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents);
+    }
+    qint64 loadNs = timer.nsecsElapsed();
+
+    QList<int> pressedKeys;
+    int nextEvent = 0;
+    int tick = 0;
+
+    timer.restart();
+    for (; tick < ticks && !level.isOver(); ++tick) {
+        // Apply this tick's scripted input, then feed it in the way MainWindow does
+        while (nextEvent < events.size() && events[nextEvent].tick <= tick) {
+            const ScriptEvent& event = events[nextEvent++];
+            if (event.pressed) {
+                if (!pressedKeys.contains(event.key)) {
+                    pressedKeys.append(event.key);
+                }
+            } else {
+                pressedKeys.removeOne(event.key);
+            }
+        }
+
+        if (level.player) {
+            level.player->handleInput(pressedKeys);
+        }
+        level.tick(pressedKeys);
+    }
+    qint64 runNs = timer.nsecsElapsed();
+
+    double seconds = runNs / 1e9;
+    qDebug().noquote() << QString("HeadlessRunner: Loaded in %1 ms").arg(loadNs / 1e6, 0, 'f', 1);
+    qDebug().noquote() << QString("HeadlessRunner: %1 ticks (%2 s of game time) in %3 ms, %4 ticks/s, %5 us/tick")
+                          .arg(tick)
+                          .arg(double(tick) / Level::stepRate(), 0, 'f', 1)
+                          .arg(runNs / 1e6, 0, 'f', 1)
+                          .arg(seconds > 0 ? tick / seconds : 0.0, 0, 'f', 0)
+                          .arg(tick > 0 ? runNs / 1e3 / tick : 0.0, 0, 'f', 2);
+    if (level.isOver()) {
+        qDebug() << "HeadlessRunner: Game ended on day" << level.currentDay << "after" << tick << "ticks";
+    }
+
+    return 0;
+}
\ No newline at end of file
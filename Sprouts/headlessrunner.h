@@ -0,0 +1,35 @@
+#ifndef HEADLESSRUNNER_H
+#define HEADLESSRUNNER_H
+
+#include <QString>
+#include <QVector>
+
+// Runs the game without a window (--headless): no painter and no frame
+// timer, just fixed simulation steps as fast as they go. Input comes from a
+// script of key presses and releases at given ticks. Used for measuring
+// simulation throughput, soak tests and bots.
+//
+// Script lines are "<tick> press|release <key>", where key is a Qt::Key name
+// without the "Key_" prefix (Left, Space, Return, Q, ...). Blank lines and
+// lines starting with '#' are ignored.
+class HeadlessRunner
+{
+public:
+    // Read the input script; false if it can't be read or has a bad line
+    bool loadScript(const QString& path);
+
+    // Build the level, run up to ticks steps and report throughput. Returns
+    // the process exit code.
+    int run(int ticks);
+
+private:
+    struct ScriptEvent {
+        int tick;
+        int key;
+        bool pressed;
+    };
+
+    QVector<ScriptEvent> events; // sorted by tick
+};
+
+#endif // HEADLESSRUNNER_H
@@ -0,0 +1,120 @@
+#include "hotreloader.h"
+#include "resourceloader.h"
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+
+bool HotReloader::enabled = false;
+
+HotReloader::HotReloader(QObject *parent)
+    : QObject{parent}, mapDirty(false), listingsDirty(false)
+{
+    watcher = new QFileSystemWatcher(this);
+    connect(watcher, &QFileSystemWatcher::fileChanged, this, &HotReloader::fileChanged);
+    connect(watcher, &QFileSystemWatcher::directoryChanged, this, &HotReloader::directoryChanged);
+}
+
+bool HotReloader::isImage(const QString& path)
+{
+    QString suffix = QFileInfo(path).suffix().toLower();
+    return suffix == "png" || suffix == "jpg" || suffix == "jpeg" || suffix == "bmp";
+}
+
+void HotReloader::watchImages(const QString& relativeDirectory)
+{
+    QString root = ResourceLoader::getResourcePath(relativeDirectory);
+    QStringList paths;
+    paths << root;
+
+    QDirIterator it(root, QDir::Dirs | QDir::Files | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        QString path = it.next();
+        if (it.fileInfo().isDir() || isImage(path)) {
+            paths << path;
+        }
+    }
+
+    watcher->addPaths(paths);
+    qDebug() << "HotReloader: Watching" << paths.size() << "paths under" << relativeDirectory;
+}
+
+void HotReloader::watchMapFiles(const QStringList& relativePaths)
+{
+    for (const QString& relativePath : relativePaths) {
+        QString path = ResourceLoader::getResourcePath(relativePath);
+        if (!mapFiles.contains(path)) {
+            mapFiles.insert(path);
+            watcher->addPath(path);
+        }
+    }
+}
+
+void HotReloader::fileChanged(const QString& path)
+{
+    // Editors that save by replacing the file drop it from the watch list
+    if (!watcher->files().contains(path) && QFileInfo::exists(path)) {
+        watcher->addPath(path);
+    }
+
+    if (mapFiles.contains(path)) {
+        mapDirty = true;
+    } else {
+        changedImages.insert(path);
+    }
+    sinceLastChange.start();
+}
+
+void HotReloader::directoryChanged(const QString& path)
+{
+    // Pick up images added to a watched directory
+    QDir dir(path);
+    const QStringList watched = watcher->files();
+    for (const QFileInfo& info : dir.entryInfoList(QDir::Files)) {
+        QString filePath = info.absoluteFilePath();
+        if (isImage(filePath) && !watched.contains(filePath)) {
+            watcher->addPath(filePath);
+            changedImages.insert(filePath);
+        }
+    }
+
+    listingsDirty = true;
+    sinceLastChange.start();
+}
+
+void HotReloader::applyPending()
+{
+    if (changedImages.isEmpty() && !mapDirty && !listingsDirty) {
+        return;
+    }
+    if (sinceLastChange.isValid() && sinceLastChange.elapsed() < HOT_RELOAD_SETTLE_MS) {
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    if (listingsDirty) {
+        ResourceLoader::invalidateFolderListings();
+        listingsDirty = false;
+    }
+
+    if (!changedImages.isEmpty()) {
+        QDir root(ResourceLoader::assetRoot());
+        QStringList relativePaths;
+        for (const QString& path : changedImages) {
+            ResourceLoader::invalidateImage(path);
+            relativePaths << root.relativeFilePath(path);
+        }
+        changedImages.clear();
+        emit imagesChanged(relativePaths);
+    }
+
+    if (mapDirty) {
+        mapDirty = false;
+        emit mapChanged();
+    }
+
+    qDebug() << "HotReloader: Applied changes in" << timer.elapsed() << "ms";
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+#ifndef HOTRELOADER_H
+#define HOTRELOADER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+class QFileSystemWatcher;
+
+// Changes younger than this are left to settle, so half-written files are not read
+const int HOT_RELOAD_SETTLE_MS = 150;
+
+// Development-mode watcher for asset and map files (--dev).
+// File system notifications are only collected; applyPending() invalidates the
+// affected cache entries and raises the reload signals, and is meant to be
+// called at a frame boundary.
+class HotReloader : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit HotReloader(QObject *parent = nullptr);
+
+    static bool isEnabled() { return enabled; }
+    static void setEnabled(bool on) { enabled = on; }
+
+    // Paths relative to the asset root
+    void watchImages(const QString& relativeDirectory);
+    void watchMapFiles(const QStringList& relativePaths);
+
+    void applyPending();
+
+signals:
+    void imagesChanged(const QStringList& relativePaths);
+    void mapChanged();
+
+private:
+    static bool enabled;
+
+    QFileSystemWatcher* watcher;
+    QSet<QString> mapFiles;      // Absolute paths
+    QSet<QString> changedImages; // Absolute paths
+    bool mapDirty;
+    bool listingsDirty;
+    QElapsedTimer sinceLastChange;
+
+    void fileChanged(const QString& path);
+    void directoryChanged(const QString& path);
+    static bool isImage(const QString& path);
+};
+
+#endif // HOTRELOADER_H
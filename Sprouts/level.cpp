@@ -12,30 +12,72 @@
 #include "introanimation.h"
 #include "endinganimation.h"
 #include "resourceloader.h"
+#include "triggersystem.h"
+#include "assetpreloader.h"
+#include "startupprofiler.h"
+#include "hotreloader.h"
 #include <QRandomGenerator>
+#include <QElapsedTimer>
 #include <QDebug>
-#include <QFile>
-#include <QXmlStreamReader>
 #include <QStringList>
 #include <QCoreApplication>
 #include <QDir>
 #include <algorithm>
+#include <cmath>
+#include <utility>
+
+int Level::stepHz = DEFAULT_STEP_RATE;
+bool Level::musicEnabled = true;
 
 Level::Level(QObject *parent)
-    : QObject{parent}, shopActive(false), raining(false), energyTimer(0.0f), energyDecreaseInterval(10.0f),
-      currentDay(1), currentTime(6.0f), timeSpeed(0.5f), isRaining(false)
+    : QObject{parent}, shopActive(false), raining(false),
+      currentDay(1), currentTime(6.0f), timeSpeed(0.5f), isRaining(false), player(nullptr),
+      soilLayer(nullptr), overlay(nullptr), transition(nullptr), rain(nullptr), sky(nullptr), menu(nullptr),
+      loaded(false), hotReloader(nullptr), accumulator(0.0f), successSound(nullptr), musicSound(nullptr),
+      energyTimer(0.0f), energyDecreaseInterval(10.0f)
 {
+    StartupProfiler::Scope scope("Level constructor");
 
 
     // Initialize sprite groups
     allSprites = new CameraGroup(this);
     collisionSprites = new SpriteGroup(this);
-    treeSprites = new SpriteGroup(this);
+    treeSprites = new TypedGroup<Tree>(this);
     interactionSprites = new SpriteGroup(this);
 
+    // Initialize trigger volumes for interaction zones
+    triggers = new TriggerSystem(this);
+
+    // Parse the map once; level, soil and collision setup all read from it
+    tmxMap.load("data/map.tmx");
+
+    // Initialize intro animation; it plays while the assets are decoded
+    introAnimation = new IntroAnimation([this]() {
+        // Animation completed callback - do nothing for now
+    }, this);
+    introAnimation->start();
+    
+    // Initialize ending animation
+    endingAnimation = new EndingAnimation(nullptr, this);
+
+    // Decode every image on worker threads, then build the world
+    preloader = new AssetPreloader(this);
+    preloader->addDirectory("graphics");
+    connect(preloader, &AssetPreloader::finished, this, &Level::finishLoading);
+    preloader->start();
+}
+
+void Level::finishLoading()
+{
+    if (loaded) {
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
 
     // Initialize soil layer
-    soilLayer = new SoilLayer(allSprites, collisionSprites, this);
+    soilLayer = new SoilLayer(allSprites, collisionSprites, tmxMap, &entities, this);
 
 
     // Setup the level
@@ -48,7 +90,7 @@ Level::Level(QObject *parent)
 
 
     // Initialize weather
-    rain = new Rain(allSprites, this);
+    rain = new Rain(this);
     isRaining = QRandomGenerator::global()->bounded(11) > 7; // 30% chance of rain on first day
     raining = isRaining;
     soilLayer->raining = raining;
@@ -59,29 +101,40 @@ Level::Level(QObject *parent)
 
 
     // Initialize shop
-    menu = new Menu(player, [this]() { toggleShop(); }, [this]() {
+    menu = new Menu(player, &menuWheel, [this]() { toggleShop(); }, [this]() {
         // Trigger success ending
         float totalHours = (currentDay - 1) * 24.0f + currentTime;
         endingAnimation->start(EndingType::SUCCESS, currentDay, totalHours);
     }, this);
 
-    // Initialize intro animation
-    introAnimation = new IntroAnimation([this]() {
-        // Animation completed callback - do nothing for now
-    }, this);
-    introAnimation->start();
-    
-    // Initialize ending animation
-    endingAnimation = new EndingAnimation(nullptr, this);
-
     // Setup audio
     setupAudio();
 
+    // Watch assets and the map for changes in development mode
+    if (HotReloader::isEnabled()) {
+        hotReloader = new HotReloader(this);
+        hotReloader->watchImages("graphics");
+        hotReloader->watchMapFiles(tmxMap.sourceFiles);
+        connect(hotReloader, &HotReloader::imagesChanged, this, &Level::reloadImages);
+        connect(hotReloader, &HotReloader::mapChanged, this, &Level::reloadMap);
+    }
+
+    StartupProfiler::record("Level::finishLoading", timer.nsecsElapsed());
+    loaded = true;
+    qDebug() << "Level: Image cache" << ResourceLoader::imageCacheHits() << "hits,"
+             << ResourceLoader::imageCacheMisses() << "misses";
+    StartupProfiler::report();
 }
 
 Level::~Level()
 {
-    // Cleanup is handled by Qt's parent-child system
+    // World sprites go with the entity registry (before the groups they are
+    // in); everything else is handled by Qt's parent-child system.
+    // The player and shop cancel their timers on the way out, so they have
+    // to go while the timer wheel (a member) is still alive
+    delete menu;
+    delete player;
+    ResourceLoader::reportImageMemory();
 }
 
 void Level::setup()
@@ -95,267 +148,74 @@ void Level::setup()
 
         QVector<SpriteGroup*> groundGroups;
         groundGroups.append(allSprites);
-        Generic* ground = new Generic(QPoint(0, 0), groundSurf, groundGroups, GROUND);
-        ground->setParent(this);
+        entities.adopt(new Generic(QPoint(0, 0), groundSurf, groundGroups, GROUND));
 
     } else {
 
     }
 }
 
-void Level::parseTMXCollisionLayer()
+void Level::createCollisionTiles()
 {
-    // Parse TMX collision layer data from the actual TMX file
-    QString tmxFilePath = ResourceLoader::getResourcePath("data/map.tmx");
-    QFile file(tmxFilePath);
-
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        qDebug() << "Failed to open TMX file:" << tmxFilePath;
-        return;
-    }
-
-    QXmlStreamReader xml(&file);
+    // Build collision tiles from the precomputed collision bits of the shared map model
     int collisionTileCount = 0;
     int fenceCount = 0;
-    int treeCount = 0;
-    int decorationCount = 0;
-
-    while (!xml.atEnd() && !xml.hasError()) {
-        QXmlStreamReader::TokenType token = xml.readNext();
-
-        if (token == QXmlStreamReader::StartElement) {
-            // Parse Collision layer
-            if (xml.name() == QLatin1String("layer")) {
-                QXmlStreamAttributes attributes = xml.attributes();
-                QString layerName = attributes.value("name").toString();
-
-                if (layerName == "Collision" || layerName == "Fence") {
-                    // Find the data element for this layer
-                    while (!xml.atEnd() && !(xml.isStartElement() && xml.name() == QLatin1String("data"))) {
-                        xml.readNext();
-                    }
-
-                    if (xml.isStartElement() && xml.name() == QLatin1String("data")) {
-                        QString csvData = xml.readElementText().trimmed();
-                        QStringList lines = csvData.split('\n', Qt::SkipEmptyParts);
-
-                        for (int y = 0; y < lines.size(); ++y) {
-                            QStringList values = lines[y].split(',', Qt::SkipEmptyParts);
-                            for (int x = 0; x < values.size(); ++x) {
-                                int tileId = values[x].trimmed().toInt();
-                                // Create collision for specific conditions
-                                bool shouldCreateCollision = false;
-                                if (layerName == "Collision" && tileId == 170) {
-                                    shouldCreateCollision = true;
-                                } else if (layerName == "Fence" && tileId != 0) {
-                                    shouldCreateCollision = true;
-                                }
-
-                                if (shouldCreateCollision) {
-                                    QPixmap collisionSurf(TILE_SIZE, TILE_SIZE);
-                                    collisionSurf.fill(Qt::transparent);
-
-                                    QVector<SpriteGroup*> groups;
-                                    if (layerName == "Fence") {
-                                        groups.append(allSprites);
-                                        groups.append(collisionSprites);
-                                        fenceCount++;
-                                    } else {
-                                        groups.append(collisionSprites);
-                                        collisionTileCount++;
-                                    }
-
-                                    Generic* collisionTile = new Generic(QPoint(x * TILE_SIZE, y * TILE_SIZE),
-                                                                        collisionSurf, groups, MAIN);
-                                    collisionTile->hitbox = QRect(x * TILE_SIZE, y * TILE_SIZE, TILE_SIZE, TILE_SIZE);
-                                    collisionTile->setParent(this);
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-            // Parse Trees and Decoration objectgroups
-            else if (xml.name() == QLatin1String("objectgroup")) {
-                QXmlStreamAttributes attributes = xml.attributes();
-                QString groupName = attributes.value("name").toString();
-
-                if (groupName == "Trees" || groupName == "Decoration") {
-                     while (!xml.atEnd() && xml.name() != QLatin1String("objectgroup")) {
-                         xml.readNext();
-                         if (xml.isStartElement() && xml.name() == QLatin1String("object")) {
-                            QXmlStreamAttributes objAttrs = xml.attributes();
-                            int x = objAttrs.value("x").toInt();
-                            int y = objAttrs.value("y").toInt();
-                            int width = objAttrs.value("width").toInt();
-                            int height = objAttrs.value("height").toInt();
-
-                            QPixmap objSurf(width, height);
-                            objSurf.fill(Qt::transparent);
-
-                            QVector<SpriteGroup*> groups;
-                            groups.append(allSprites);
-                            groups.append(collisionSprites);
-
-                            if (groupName == "Trees") {
-                                groups.append(treeSprites);
-                                treeCount++;
-                            } else {
-                                decorationCount++;
-                            }
-
-                            Generic* objSprite = new Generic(QPoint(x, y - height), objSurf, groups, MAIN);
-                            objSprite->hitbox = QRect(x, y - height, width, height);
-                            objSprite->setParent(this);
-                        }
-                    }
-                }
-            }
-        }
-    }
+    const TmxLayer* fenceLayer = tmxMap.layer("Fence");
 
-    file.close();
+    for (int y = 0; y < tmxMap.height; ++y) {
+        for (int x = 0; x < tmxMap.width; ++x) {
+            if (!tmxMap.isCollision(x, y)) {
+                continue;
+            }
 
-    if (xml.hasError()) {
+            QPixmap collisionSurf(TILE_SIZE, TILE_SIZE);
+            collisionSurf.fill(Qt::transparent);
+
+            // Fences are also drawn, plain collision tiles only block movement
+            QVector<SpriteGroup*> groups;
+            bool isFence = fenceLayer && x < fenceLayer->width && y < fenceLayer->height
+                           && fenceLayer->tileAt(x, y) != 0;
+            if (isFence) {
+                groups.append(allSprites);
+                groups.append(collisionSprites);
+                fenceCount++;
+            } else {
+                groups.append(collisionSprites);
+                collisionTileCount++;
+            }
 
-        return;
+            Generic* collisionTile = entities.adopt(new Generic(QPoint(x * TILE_SIZE, y * TILE_SIZE),
+                                                                    collisionSurf, groups, MAIN));
+            collisionTile->hitbox = QRect(x * TILE_SIZE, y * TILE_SIZE, TILE_SIZE, TILE_SIZE);
+            collisionTiles.append(collisionTile);
+        }
     }
 
-
+    qDebug() << "Level: Created" << collisionTileCount << "collision tiles and" << fenceCount << "fence tiles";
 }
 
 void Level::loadTilesets()
 {
-    // Parse TSX files to get correct tileset information
-    QMap<QString, int> tilesetFiles = {
-        {"data/Tilesets/Grass.tsx", 1},
-        {"data/Tilesets/Hills.tsx", 81},
-        {"data/Tilesets/Fences.tsx", 117},
-        {"data/Tilesets/Plant Decoration.tsx", 133},
-        {"data/Tilesets/Objects.tsx", 143},
-        {"data/Tilesets/Paths.tsx", 153},
-        {"data/Tilesets/interaction.tsx", 169},
-        {"data/Tilesets/Water.tsx", 171},
-        {"data/Tilesets/House.tsx", 172},
-        {"data/Tilesets/House Decoration.tsx", 207}
-    };
-    
-    for (auto it = tilesetFiles.begin(); it != tilesetFiles.end(); ++it) {
-        QString tsxPath = it.key();
-        int firstGid = it.value();
-        
-        // Use ResourceLoader to get the correct path
-        QString fullTsxPath = ResourceLoader::getResourcePath(tsxPath);
-        QFile tsxFile(fullTsxPath);
-        
-        if (tsxFile.exists() && tsxFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-            QXmlStreamReader xml(&tsxFile);
-            bool hasIndividualTiles = false;
-            int currentTileId = 0;
-            
-            while (!xml.atEnd() && !xml.hasError()) {
-                xml.readNext();
-                
-                if (xml.isStartElement()) {
-                    if (xml.name() == QLatin1String("tileset")) {
-                        // Check if this tileset has individual tiles (columns=0)
-                        QXmlStreamAttributes attrs = xml.attributes();
-                        int columns = attrs.value("columns").toInt();
-                        hasIndividualTiles = (columns == 0);
-                    }
-                    else if (xml.name() == QLatin1String("tile") && hasIndividualTiles) {
-                        QXmlStreamAttributes attrs = xml.attributes();
-                        currentTileId = attrs.value("id").toInt();
-                    }
-                    else if (xml.name() == QLatin1String("image")) {
-                        QXmlStreamAttributes attrs = xml.attributes();
-                        QString imagePath = attrs.value("source").toString();
-                        
-                        // Convert relative path to absolute
-                        if (imagePath.startsWith("../../")) {
-                            imagePath = imagePath.mid(6); // Remove "../../"
-                        }
-                        
-                        QPixmap tileImage = ResourceLoader::loadImage(imagePath);
-                        if (!tileImage.isNull()) {
-                            if (hasIndividualTiles) {
-                                // Store individual tile image
-                                int globalTileId = firstGid + currentTileId;
-                                individualTileImages[globalTileId] = tileImage;
-                            } else {
-                                // Store tileset image
-                                tilesetImages[firstGid] = tileImage;
-                            }
-                        }
-                    }
+    // Tileset references were resolved from their TSX files when the map was parsed
+    for (const TmxTileset& tileset : tmxMap.tilesets) {
+        StartupProfiler::Scope scope("loadTilesets: " + tileset.source);
+        if (tileset.columns == 0) {
+            // Store individual tile images
+            for (auto it = tileset.tileImages.begin(); it != tileset.tileImages.end(); ++it) {
+                QPixmap tileImage = ResourceLoader::loadImage(it.value());
+                if (!tileImage.isNull()) {
+                    int globalTileId = tileset.firstGid + it.key();
+                    individualTileImages[globalTileId] = tileImage;
                 }
             }
-            
-            tsxFile.close();
-        } else {
-            qDebug() << "Failed to open TSX file:" << fullTsxPath;
-        }
-    }
-}
-
-void Level::parseTMXVisualLayers()
-{
-    QString tmxFilePath = ResourceLoader::getResourcePath("data/map.tmx");
-    QFile file(tmxFilePath);
-    
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        qDebug() << "Failed to open TMX file for visual layers:" << tmxFilePath;
-        return;
-    }
-    
-    QXmlStreamReader xml(&file);
-    
-    while (!xml.atEnd() && !xml.hasError()) {
-        QXmlStreamReader::TokenType token = xml.readNext();
-        
-        if (token == QXmlStreamReader::StartElement && xml.name() == QLatin1String("layer")) {
-            QXmlStreamAttributes attributes = xml.attributes();
-            QString layerName = attributes.value("name").toString();
-            
-            // Skip only the Collision layer as it's handled separately
-             if (layerName == "Collision") {
-                 // Skip to the end of this layer
-                 while (!xml.atEnd() && !(xml.isEndElement() && xml.name() == QLatin1String("layer"))) {
-                     xml.readNext();
-                 }
-                 continue;
-             }
-            
-            // Parse visual layers (Water, HouseFloor, HouseFurniture, etc.)
-            while (!xml.atEnd() && !(xml.isStartElement() && xml.name() == QLatin1String("data"))) {
-                xml.readNext();
-            }
-            
-            if (xml.isStartElement() && xml.name() == QLatin1String("data")) {
-                QString csvData = xml.readElementText().trimmed();
-                QStringList lines = csvData.split('\n', Qt::SkipEmptyParts);
-                
-                QVector<QVector<int>> layerData;
-                for (const QString& line : lines) {
-                    QStringList values = line.split(',', Qt::SkipEmptyParts);
-                    QVector<int> rowData;
-                    for (const QString& value : values) {
-                        rowData.append(value.trimmed().toInt());
-                    }
-                    layerData.append(rowData);
-                }
-                
-                mapLayers.append(layerData);
-                layerNames.append(layerName);
+        } else if (!tileset.imageSource.isEmpty()) {
+            // Store tileset image
+            QPixmap tileImage = ResourceLoader::loadImage(tileset.imageSource);
+            if (!tileImage.isNull()) {
+                tilesetImages[tileset.firstGid] = tileImage;
             }
         }
     }
-    
-    file.close();
-    
-    if (xml.hasError()) {
-
-    }
 }
 
 void Level::renderTMXLayers(QPainter& painter, const QPointF& offset)
@@ -369,25 +229,16 @@ void Level::renderTMXLayers(QPainter& painter, const QPointF& offset)
     
     // Render layers in the correct order
     for (const QString& targetLayerName : renderOrder) {
-        // Find the layer index for this layer name
-        int layerIndex = -1;
-        for (int i = 0; i < layerNames.size(); ++i) {
-            if (layerNames[i] == targetLayerName) {
-                layerIndex = i;
-                break;
-            }
-        }
-        
-        if (layerIndex == -1 || layerIndex >= mapLayers.size()) {
+        const TmxLayer* layer = tmxMap.layer(targetLayerName);
+        if (!layer) {
             continue; // Skip if layer not found
         }
         
-        const QVector<QVector<int>>& layer = mapLayers[layerIndex];
         int tilesRendered = 0;
         
-        for (int y = 0; y < layer.size(); ++y) {
-            for (int x = 0; x < layer[y].size(); ++x) {
-                int tileId = layer[y][x];
+        for (int y = 0; y < layer->height; ++y) {
+            for (int x = 0; x < layer->width; ++x) {
+                int tileId = layer->tileAt(x, y);
                 if (tileId == 0) continue; // Skip empty tiles
                 
                 // Find the correct tileset for this tile ID
@@ -453,14 +304,11 @@ QPixmap Level::getTileImage(int tileId)
 
 void Level::loadTMXMap()
 {
-    // Load TMX map data and parse collision layer
-    parseTMXCollisionLayer();
+    // Build collision tiles from the parsed map
+    createCollisionTiles();
     
     // Load tilesets for rendering
     loadTilesets();
-    
-    // Parse all visual layers for rendering
-    parseTMXVisualLayers();
 
     // Create some trees
     QPixmap treeSmallSurf = ResourceLoader::loadImage("graphics/objects/tree_small.png");
@@ -474,10 +322,10 @@ void Level::loadTMXMap()
         treeGroups.append(treeSprites);
 
         // Create some trees at various positions
-        Tree* tree1 = new Tree(QPoint(200, 200), treeSmallSurf, treeGroups, "Small",
-                              [this](const QString& item) { playerAdd(item); }, this);
-        Tree* tree2 = new Tree(QPoint(400, 300), treeSmallSurf, treeGroups, "Small",
-                              [this](const QString& item) { playerAdd(item); }, this);
+        entities.adopt(new Tree(QPoint(200, 200), treeSmallSurf, treeGroups, "Small",
+                                    [this](const QString& item) { playerAdd(item); }, &effects));
+        entities.adopt(new Tree(QPoint(400, 300), treeSmallSurf, treeGroups, "Small",
+                                    [this](const QString& item) { playerAdd(item); }, &effects));
 
     } else {
 
@@ -492,33 +340,41 @@ void Level::loadTMXMap()
         // Create some water tiles
         for (int x = 30; x < 35; ++x) {
             for (int y = 7; y < 12; ++y) {
-                Water* water = new Water(QPoint(x * TILE_SIZE, y * TILE_SIZE), waterFrames, waterGroups);
-                water->setParent(this);
+                entities.adopt(new Water(QPoint(x * TILE_SIZE, y * TILE_SIZE), waterFrames, waterGroups));
             }
         }
     }
 
     // Create player
     player = new Player(QPointF(640, 360), allSprites, collisionSprites, treeSprites,
-                       interactionSprites, soilLayer, [this]() { toggleShop(); }, this);
+                       triggers, soilLayer, &timerWheel, [this]() { toggleShop(); }, this);
     player->level = this;
 
 
-    // Create some interaction objects
+    // Create interaction objects (Trader, Bed) from the map's Player object group
     QVector<SpriteGroup*> interactionGroups;
     interactionGroups.append(interactionSprites);
 
-    // Trader
-    Interaction* trader = new Interaction(QPoint(895, 379), QSize(192, 131), interactionGroups, "Trader");
-    trader->setParent(this);
+    if (const TmxObjectGroup* playerGroup = tmxMap.objectGroup("Player")) {
+        for (const TmxObject& object : playerGroup->objects) {
+            if (object.name != "Trader" && object.name != "Bed") {
+                continue;
+            }
+
+            QRect bounds = object.bounds.toRect();
+            Interaction* zone = entities.adopt(new Interaction(bounds.topLeft(), bounds.size(),
+                                                                   interactionGroups, object.name));
+            triggers->addZone(zone);
+        }
+    }
 
-    // Bed
-    Interaction* bed = new Interaction(QPoint(1408, 1403), QSize(64, 66), interactionGroups, "Bed");
-    bed->setParent(this);
+    // Pick up any zone the player spawns inside
+    triggers->update(player->rect);
 }
 
 void Level::setupAudio()
 {
+    StartupProfiler::Scope scope("Level::setupAudio");
     successSound = new QSoundEffect(this);
     QString successPath = ResourceLoader::getResourcePath("audio/success.wav");
     successSound->setSource(QUrl::fromLocalFile(successPath));
@@ -529,11 +385,24 @@ void Level::setupAudio()
     musicSound->setSource(QUrl::fromLocalFile(musicPath));
     musicSound->setVolume(0.5);
     musicSound->setLoopCount(QSoundEffect::Infinite);
-    musicSound->play();
+    if (musicEnabled) {
+        musicSound->play();
+    }
 }
 
 void Level::run(float dt, QPainter& painter, const QList<int>& pressedKeys)
 {
+    // Free sprites killed last frame
+    entities.flush();
+
+    // Age the image cache and sample image memory
+    ResourceLoader::beginFrame();
+
+    // Apply asset changes between frames
+    if (hotReloader) {
+        hotReloader->applyPending();
+    }
+
     // Handle intro animation first
     if (introAnimation && introAnimation->isActive()) {
         // Update and display intro animation
@@ -559,41 +428,66 @@ void Level::run(float dt, QPainter& painter, const QList<int>& pressedKeys)
         return; // Don't run normal game logic during ending
     }
     
-    // Game loop running normally
-
-    // Draw sky background first
-    if (sky) {
-        sky->display(painter, dt);
+    // Gameplay starts once the assets are decoded
+    if (!loaded) {
+        painter.fillRect(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, Qt::black);
+        painter.setPen(Qt::white);
+        painter.setFont(QFont("Arial", 16));
+        painter.drawText(QRect(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT), Qt::AlignCenter,
+                         QString("加载中... %1/%2").arg(preloader->completedCount()).arg(preloader->totalCount()));
+        return;
     }
     
-    // Draw map layers
-    if (player) {
-        QPointF offset;
-        offset.setX(player->rect.center().x() - SCREEN_WIDTH / 2.0);
-        offset.setY(player->rect.center().y() - SCREEN_HEIGHT / 2.0);
-        renderTMXLayers(painter, offset);
+    // Game loop running normally: the world advances in fixed steps, however
+    // long the frame took, and is drawn once blended between the last two
+    accumulator += dt;
+    const float stepDt = 1.0f / stepHz;
+    int steps = 0;
+    while (accumulator >= stepDt && steps < MAX_CATCH_UP_STEPS) {
+        step(stepDt, pressedKeys);
+        accumulator -= stepDt;
+        ++steps;
+        
+        // The ending takes over as soon as it starts
+        if (endingAnimation && endingAnimation->isActive()) {
+            accumulator = 0.0f;
+            break;
+        }
+    }
+    
+    // After a long stall, drop the backlog rather than falling further behind
+    if (accumulator >= stepDt) {
+        accumulator = std::fmod(accumulator, stepDt);
     }
+    
+    draw(painter, accumulator / stepDt);
+}
 
-    // Draw all sprites
-    if (allSprites && player) {
-        allSprites->customDraw(painter, player);
+void Level::tick(const QList<int>& pressedKeys)
+{
+    if (!loaded || isOver()) {
+        return;
     }
     
-    // Draw plant sprites separately
-    if (soilLayer && soilLayer->plantSprites && player) {
-        // Calculate camera offset (same as CameraGroup)
-        QPointF offset;
-        offset.setX(player->rect.center().x() - SCREEN_WIDTH / 2.0);
-        offset.setY(player->rect.center().y() - SCREEN_HEIGHT / 2.0);
-        
-        // Draw each plant sprite
-        for (Sprite* sprite : soilLayer->plantSprites->sprites()) {
-            if (sprite && sprite->alive) {
-                QRect offsetRect = sprite->rect;
-                offsetRect.translate(-offset.x(), -offset.y());
-                painter.drawPixmap(offsetRect, sprite->image);
-            }
-        }
+    entities.flush();
+    step(1.0f / stepHz, pressedKeys);
+}
+
+bool Level::isOver() const
+{
+    return endingAnimation && endingAnimation->isActive();
+}
+
+void Level::setStepRate(int hz)
+{
+    stepHz = qMax(1, hz);
+}
+
+void Level::step(float dt, const QList<int>& pressedKeys)
+{
+    menuWheel.advance(dt);
+    if (!shopActive) {
+        timerWheel.advance(dt);
     }
 
     // Update energy system (always check, regardless of shop state)
@@ -630,14 +524,23 @@ void Level::run(float dt, QPainter& painter, const QList<int>& pressedKeys)
     // Update game objects
     if (shopActive) {
         if (menu) {
-            menu->update(dt);
             menu->handleInput(pressedKeys);
-            menu->display(painter);
+        }
+        
+        // The world is paused, so nothing should be drawn mid-step
+        if (allSprites) {
+            allSprites->snapPositions();
         }
     } else {
         if (allSprites) {
             allSprites->update(dt);
         }
+        effects.update(dt);
+
+        // Refresh trigger volumes after the player has moved
+        if (triggers && player) {
+            triggers->update(player->rect);
+        }
         
         // Update plant sprites separately
         if (soilLayer && soilLayer->plantSprites) {
@@ -665,14 +568,11 @@ void Level::run(float dt, QPainter& painter, const QList<int>& pressedKeys)
          plantCollision();
     }
 
-    // Display overlay
-    if (!shopActive && overlay) {
-        overlay->display(painter);
-    }
-
-    // Weather effects
-    if (raining && !shopActive && rain) {
-        rain->update(dt);
+    // Weather effects, simulated around the player rather than the last drawn
+    // camera so headless runs (which never draw) see the same rain
+    if (raining && !shopActive && rain && player) {
+        QPointF viewTopLeft = QPointF(player->rect.center()) - QPointF(SCREEN_WIDTH / 2.0, SCREEN_HEIGHT / 2.0);
+        rain->update(dt, QRectF(viewTopLeft, QSizeF(SCREEN_WIDTH, SCREEN_HEIGHT)));
     }
 
     // Transition overlay
@@ -681,6 +581,125 @@ void Level::run(float dt, QPainter& painter, const QList<int>& pressedKeys)
     }
 }
 
+void Level::draw(QPainter& painter, float alpha)
+{
+    // Draw sky background first
+    if (sky) {
+        sky->display(painter, 1.0f / stepHz);
+    }
+    
+    // Camera follows the player as drawn this frame
+    if (allSprites && player) {
+        allSprites->follow(player, alpha);
+        
+        // Draw map layers
+        renderTMXLayers(painter, allSprites->offset);
+
+        // Draw all sprites
+        allSprites->customDraw(painter, alpha);
+    }
+    
+    // Draw plant sprites separately
+    if (soilLayer && soilLayer->plantSprites && allSprites && player) {
+        // Draw each plant sprite
+        for (Plant* plant : *soilLayer->plantSprites) {
+            QRectF offsetRect(plant->rect);
+            offsetRect.translate(-allSprites->offset);
+            painter.drawPixmap(offsetRect, plant->image, QRectF(plant->image.rect()));
+        }
+    }
+
+    // Flashes go over the sprites they came from
+    if (allSprites) {
+        effects.draw(painter, allSprites->offset);
+    }
+
+    // Rain goes over everything in the world
+    if (raining && !shopActive && rain && allSprites) {
+        rain->display(painter, allSprites->offset);
+    }
+
+    // Shop or overlay on top
+    if (shopActive) {
+        if (menu) {
+            menu->display(painter);
+        }
+    } else if (overlay) {
+        overlay->display(painter);
+    }
+}
+
+void Level::reloadImages(const QStringList& relativePaths)
+{
+    bool tilesets = false;
+    bool character = false;
+    bool soil = false;
+    bool overlayIcons = false;
+
+    for (const QString& path : relativePaths) {
+        if (path.startsWith("graphics/character/")) {
+            character = true;
+        } else if (path.startsWith("graphics/soil/") || path.startsWith("graphics/soil_water/")) {
+            soil = true;
+        } else if (path.startsWith("graphics/overlay/")) {
+            overlayIcons = true;
+        }
+
+        for (const TmxTileset& tileset : tmxMap.tilesets) {
+            if (tileset.imageSource == path || tileset.tileImages.values().contains(path)) {
+                tilesets = true;
+            }
+        }
+    }
+
+    // Rebuild only what uses the changed images
+    if (tilesets) {
+        tilesetImages.clear();
+        individualTileImages.clear();
+        loadTilesets();
+    }
+    if (character) {
+        player->reloadClips();
+    }
+    if (soil) {
+        soilLayer->reloadGraphics();
+    }
+    if (overlayIcons) {
+        overlay->reloadGraphics();
+    }
+    effects.pruneMasks();
+
+    qDebug() << "Level: Reloaded" << relativePaths.size() << "images";
+}
+
+void Level::reloadMap()
+{
+    // Parse into a separate map so a failed load (e.g. the editor is halfway
+    // through saving) leaves the live one untouched
+    TmxMap reloaded;
+    if (!reloaded.load("data/map.tmx")) {
+        qDebug() << "Level: Map reload failed, keeping the previous map";
+        return;
+    }
+    tmxMap = std::move(reloaded);
+
+    // Layers are read from the map every frame; collision tiles and tilesets are derived
+    for (Sprite* tile : collisionTiles) {
+        tile->kill();
+    }
+    collisionTiles.clear();
+    createCollisionTiles();
+
+    tilesetImages.clear();
+    individualTileImages.clear();
+    loadTilesets();
+
+    // Tilesets may have been added to the map
+    hotReloader->watchMapFiles(tmxMap.sourceFiles);
+
+    qDebug() << "Level: Reloaded map";
+}
+
 void Level::playerAdd(const QString& item)
 {
     if (player->inventory.contains(item)) {
@@ -717,16 +736,18 @@ void Level::reset()
     }
 
     // Reset apples on trees
-    for (Sprite* sprite : treeSprites->sprites()) {
-        Tree* tree = qobject_cast<Tree*>(sprite);
-        if (tree) {
-            // Clear existing apples and create new ones
-            tree->createFruit();
-        }
+    for (Tree* tree : *treeSprites) {
+        // Clear existing apples and create new ones
+        tree->createFruit();
     }
 
     // Reset sky
     sky->startColor = QColor(255, 255, 255);
+
+    // Flashes from yesterday's plants and trees are long finished
+    effects.pruneMasks();
+
+    ResourceLoader::reportImageMemory();
 }
 
 void Level::plantCollision()
@@ -735,10 +756,9 @@ void Level::plantCollision()
         return;
     }
 
-    for (Sprite* sprite : soilLayer->plantSprites->sprites()) {
+    for (Plant* plant : *soilLayer->plantSprites) {
         // Check if plant is harvestable and collides with player
-        Plant* plant = qobject_cast<Plant*>(sprite);
-        if (plant && plant->harvestable && sprite->rect.intersects(player->hitbox)) {
+        if (plant->harvestable && plant->rect.intersects(player->hitbox)) {
             // Remove plant from soil grid
             QPoint gridPos = soilLayer->worldToGrid(plant->getWorldPosition());
             if (soilLayer->isValidGridPos(gridPos)) {
@@ -754,14 +774,12 @@ void Level::plantCollision()
             // Harvesting consumes 1 energy
             player->decreaseEnergy(1);
             
-            sprite->kill();
+            plant->kill();
 
             // Create particle effect
-            QVector<SpriteGroup*> particleGroups;
-            particleGroups.append(allSprites);
-            Particle* particle = new Particle(sprite->rect.topLeft(), sprite->image, particleGroups, MAIN);
-            particle->setParent(this);
+            effects.flash(plant->rect.topLeft(), plant->image);
 
+            // Killing reorders the group
             break;
         }
     }
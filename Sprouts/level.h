@@ -6,10 +6,14 @@
 #include <QSoundEffect>
 #include <QRandomGenerator>
 #include "gamesettings.h"
+#include "tmxmap.h"
+#include "entityregistry.h"
+#include "effectsystem.h"
+#include "spritegroup.h"
+#include "timerwheel.h"
 
 class Player;
-class CameraGroup;
-class SpriteGroup;
+class Tree;
 class SoilLayer;
 class Overlay;
 class Transition;
@@ -18,6 +22,9 @@ class Sky;
 class Menu;
 class IntroAnimation;
 class EndingAnimation;
+class TriggerSystem;
+class AssetPreloader;
+class HotReloader;
 
 class Level : public QObject
 {
@@ -27,11 +34,25 @@ public:
     explicit Level(QObject *parent = nullptr);
     ~Level();
     
-    // Main game loop
+    // Main game loop: dt is the frame time, the world itself advances in
+    // fixed steps of 1 / stepRate() seconds
     void run(float dt, QPainter& painter, const QList<int>& pressedKeys = QList<int>());
     
+    // One fixed step of game logic with no drawing, for headless runs. Does
+    // nothing until the level is loaded or once the game has ended.
+    void tick(const QList<int>& pressedKeys = QList<int>());
+    bool isOver() const;
+    
+    // Simulation rate in steps per second (--tick-rate)
+    static void setStepRate(int hz);
+    static int stepRate() { return stepHz; }
+    
+    // Background music; off for headless runs
+    static void setMusicEnabled(bool on) { musicEnabled = on; }
+    
     // Setup
     void setup();
+    bool isLoaded() const { return loaded; }
     
     // Game actions
     void playerAdd(const QString& item);
@@ -51,11 +72,12 @@ public:
 
     // Core components
     Player* player;
+    TriggerSystem* triggers;
     
 private:
     CameraGroup* allSprites;
     SpriteGroup* collisionSprites;
-    SpriteGroup* treeSprites;
+    TypedGroup<Tree>* treeSprites;
     SpriteGroup* interactionSprites;
     
     // Game systems
@@ -68,6 +90,37 @@ private:
     IntroAnimation* introAnimation;
     EndingAnimation* endingAnimation;
     
+    // Background asset decoding; the world is built once it finishes
+    AssetPreloader* preloader;
+    bool loaded;
+    void finishLoading();
+    
+    // Development-mode hot reload (--dev)
+    HotReloader* hotReloader;
+    
+    // Fixed-step simulation: frame time not yet simulated, and one step of
+    // game logic / one frame of drawing blended by alpha between steps
+    static int stepHz;
+    static bool musicEnabled;
+    float accumulator;
+    void step(float dt, const QList<int>& pressedKeys);
+    void draw(QPainter& painter, float alpha);
+    QVector<Sprite*> collisionTiles;
+    
+    // World sprites owned by the level (ground, collision, water, trees, zones,
+    // soil and plants); killed ones are freed at the start of the next frame
+    EntityRegistry entities;
+    // Harvest and tree-chop flashes, shared with the trees
+    EffectSystem effects;
+    // Player cooldowns, advanced with game time so they pause during the
+    // intro, the ending, loading and while the shop is open
+    TimerWheel timerWheel;
+    // Shop input cooldown; keeps running while the world wheel is paused
+    TimerWheel menuWheel;
+    
+    void reloadImages(const QStringList& relativePaths);
+    void reloadMap();
+    
     // Audio
     QSoundEffect* successSound;
     QSoundEffect* musicSound;
@@ -81,18 +134,18 @@ private:
     
     // Methods
     void loadTMXMap();
-    void parseTMXCollisionLayer();
-    void parseTMXVisualLayers();
+    void createCollisionTiles();
     void renderTMXLayers(QPainter& painter, const QPointF& offset);
     void loadTilesets();
     QPixmap getTileImage(int tileId);
     void setupAudio();
     
+    // Map data, parsed once from data/map.tmx
+    TmxMap tmxMap;
+
     // Map rendering data
     QMap<int, QPixmap> tilesetImages;
     QMap<int, QPixmap> individualTileImages; // For tilesets with individual tile images
-    QVector<QVector<QVector<int>>> mapLayers; // [layer][y][x]
-    QStringList layerNames;
 };
 
 #endif // LEVEL_H
\ No newline at end of file
@@ -1,11 +1,105 @@
 #include "mainwindow.h"
+#include "resourceloader.h"
+#include "assetpack.h"
+#include "texturecache.h"
+#include "startupprofiler.h"
+#include "hotreloader.h"
+#include "level.h"
+#include "headlessrunner.h"
+#include "benchmarks.h"
 
 #include <QApplication>
+#include <QCommandLineParser>
 
 int main(int argc, char *argv[])
 {
+    // Headless runs never open a window; images still need a GUI application,
+    // so use the offscreen platform unless one was picked explicitly
+    for (int i = 1; i < argc; ++i) {
+        if (QByteArray(argv[i]) == "--headless" && !qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) {
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+        }
+    }
+
     QApplication a(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption assetsOption("assets", "Directory containing graphics/, audio/, data/ and font/.", "dir");
+    parser.addOption(assetsOption);
+    QCommandLineOption buildPackOption("build-pack", "Pack the game assets into <file> and exit.", "file");
+    parser.addOption(buildPackOption);
+    QCommandLineOption noTextureCacheOption("no-texture-cache", "Always decode images from their source files.");
+    parser.addOption(noTextureCacheOption);
+    QCommandLineOption startupReportOption("startup-report", "Print a table of startup phase timings.");
+    parser.addOption(startupReportOption);
+    QCommandLineOption startupReportJsonOption("startup-report-json", "Also write the startup report to <file> as JSON.", "file");
+    parser.addOption(startupReportJsonOption);
+    QCommandLineOption imageBudgetOption("image-budget", "Memory budget for decoded images, in MiB.", "mib");
+    parser.addOption(imageBudgetOption);
+    QCommandLineOption tickRateOption("tick-rate", "Game simulation steps per second (default 60).", "hz");
+    parser.addOption(tickRateOption);
+    QCommandLineOption headlessOption("headless", "Run the simulation without a window, as fast as it goes, and report throughput.");
+    parser.addOption(headlessOption);
+    QCommandLineOption ticksOption("ticks", "Number of simulation steps to run headless (default 3600).", "n", "3600");
+    parser.addOption(ticksOption);
+    QCommandLineOption scriptOption("script", "Timed key presses to feed a headless run.", "file");
+    parser.addOption(scriptOption);
+    QCommandLineOption benchOption("bench", "With --headless, run a micro-benchmark instead of the game: "
+                                   + Benchmarks::names().join(", ") + ".", "name");
+    parser.addOption(benchOption);
+    QCommandLineOption benchSizeOption("bench-size", "Problem size for --bench (default depends on the benchmark).", "n", "0");
+    parser.addOption(benchSizeOption);
+    QCommandLineOption devOption("dev", "Development mode: reload changed assets and the map while running.");
+    parser.addOption(devOption);
+    parser.process(a);
+
+    HotReloader::setEnabled(parser.isSet(devOption));
+
+    if (parser.isSet(tickRateOption)) {
+        Level::setStepRate(parser.value(tickRateOption).toInt());
+    }
+
+    if (parser.isSet(imageBudgetOption)) {
+        ResourceLoader::setImageBudget(parser.value(imageBudgetOption).toLongLong() * 1024 * 1024);
+    }
+
+    if (parser.isSet(startupReportOption) || parser.isSet(startupReportJsonOption)) {
+        StartupProfiler::setEnabled(true);
+        StartupProfiler::setJsonPath(parser.value(startupReportJsonOption));
+    }
+
+    TextureCache::setEnabled(!parser.isSet(noTextureCacheOption));
+
+    if (parser.isSet(assetsOption)) {
+        ResourceLoader::setAssetRoot(parser.value(assetsOption));
+    }
+
+    if (parser.isSet(buildPackOption)) {
+        QStringList folders;
+        folders << "graphics" << "data";
+        return AssetPack::build(ResourceLoader::assetRoot(), folders, parser.value(buildPackOption)) ? 0 : 1;
+    }
+
+    // Read assets from the pack when one ships next to them; in development
+    // mode the loose files are what gets edited, so the pack is ignored
+    if (!HotReloader::isEnabled()) {
+        ResourceLoader::openPack(ResourceLoader::getResourcePath("assets.pack"));
+    }
+
+    if (parser.isSet(headlessOption) && parser.isSet(benchOption)) {
+        return Benchmarks::run(parser.value(benchOption), parser.value(benchSizeOption).toInt());
+    }
+
+    if (parser.isSet(headlessOption)) {
+        HeadlessRunner runner;
+        if (parser.isSet(scriptOption) && !runner.loadScript(parser.value(scriptOption))) {
+            return 1;
+        }
+        return runner.run(parser.value(ticksOption).toInt());
+    }
+
     MainWindow w;
     w.show();
     return a.exec();
-}
+}
\ No newline at end of file
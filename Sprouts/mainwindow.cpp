@@ -37,6 +37,7 @@ void MainWindow::setupGame()
     
     // Setup game timer
     gameTimer = new QTimer(this);
+    gameTimer->setTimerType(Qt::PreciseTimer);
     connect(gameTimer, &QTimer::timeout, this, &MainWindow::gameLoop);
     gameTimer->start(16); // ~60 FPS
     
@@ -48,11 +49,6 @@ void MainWindow::setupGame()
 
 void MainWindow::gameLoop()
 {
-    // Calculate delta time
-    qint64 currentTime = elapsedTimer->elapsed();
-    deltaTime = (currentTime - lastFrameTime) / 1000.0f;
-    lastFrameTime = currentTime;
-    
     // Update input
     updateInput();
     
@@ -82,6 +78,12 @@ void MainWindow::paintEvent(QPaintEvent *event)
     }
     paintCounter++;
     
+    // Frame time is measured per paint, so extra repaints (expose, resize)
+    // don't replay the previous frame's delta; Level turns it into fixed steps
+    qint64 currentTime = elapsedTimer->elapsed();
+    deltaTime = (currentTime - lastFrameTime) / 1000.0f;
+    lastFrameTime = currentTime;
+    
     QPainter painter(this);
     painter.setRenderHint(QPainter::Antialiasing);
     
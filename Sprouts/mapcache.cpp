@@ -0,0 +1,259 @@
+#include "mapcache.h"
+#include "tmxmap.h"
+#include "resourceloader.h"
+#include "startupprofiler.h"
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <cstring>
+
+namespace {
+
+const char MAP_CACHE_MAGIC[4] = { 'S', 'P', 'M', 'C' };
+const quint32 MAP_CACHE_BYTE_ORDER = 0x01020304;
+const int MAP_CACHE_ALIGNMENT = 8;
+
+struct MapCacheHeader {
+    char magic[4];
+    quint32 version;
+    quint32 byteOrder;
+    quint32 metaOffset;
+    quint32 metaSize;
+    quint32 reserved[3];
+};
+
+// Append a section padded to the cache alignment and return its offset
+quint32 appendSection(QByteArray& blob, const QByteArray& section)
+{
+    while (blob.size() % MAP_CACHE_ALIGNMENT != 0) {
+        blob.append('\0');
+    }
+    quint32 offset = quint32(blob.size());
+    blob.append(section);
+    return offset;
+}
+
+}
+
+QString MapCache::cacheFilePath(const QString& relativePath)
+{
+    // Key the cache on the resolved source path so different checkouts do not collide
+    QString sourcePath = QFileInfo(ResourceLoader::getResourcePath(relativePath)).absoluteFilePath();
+    QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/maps";
+    return cacheDir + "/" + QFileInfo(relativePath).completeBaseName() + "-"
+           + QString::number(qHash(sourcePath), 16) + ".mapcache";
+}
+
+bool MapCache::save(const TmxMap& map, const QString& relativePath)
+{
+    QByteArray blob(int(sizeof(MapCacheHeader)), '\0');
+
+    // Raw sections first so they keep their alignment in the mapped file
+    QVector<quint32> tileOffsets;
+    for (const TmxLayer& layer : map.layers) {
+        tileOffsets.append(appendSection(blob, layer.tiles));
+    }
+    quint32 collisionOffset = appendSection(blob, map.collisionMask);
+    quint32 farmableOffset = appendSection(blob, map.farmableMask);
+
+    QByteArray meta;
+    QDataStream out(&meta, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_15);
+
+    // Source files with the stamps the cache was built against
+    out << quint32(map.sourceFiles.size());
+    for (const QString& source : map.sourceFiles) {
+        qint64 modified = 0;
+        qint64 size = 0;
+        ResourceLoader::fileStamp(source, modified, size);
+        out << source << modified << size;
+    }
+
+    out << qint32(map.width) << qint32(map.height) << qint32(map.tileWidth) << qint32(map.tileHeight);
+    out << map.hasFarmableLayer << collisionOffset << farmableOffset << quint32(map.collisionMask.size());
+
+    out << quint32(map.layers.size());
+    for (int i = 0; i < map.layers.size(); ++i) {
+        const TmxLayer& layer = map.layers[i];
+        out << layer.name << qint32(layer.width) << qint32(layer.height) << layer.visible
+            << tileOffsets[i] << quint32(layer.tiles.size());
+    }
+
+    out << quint32(map.objectGroups.size());
+    for (const TmxObjectGroup& group : map.objectGroups) {
+        out << group.name << quint32(group.objects.size());
+        for (const TmxObject& object : group.objects) {
+            out << qint32(object.id) << qint32(object.gid) << object.name << object.type << object.bounds;
+        }
+    }
+
+    out << quint32(map.tilesets.size());
+    for (const TmxTileset& tileset : map.tilesets) {
+        out << qint32(tileset.firstGid) << tileset.source << qint32(tileset.columns)
+            << tileset.imageSource << tileset.tileImages;
+    }
+
+    MapCacheHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MAP_CACHE_MAGIC, sizeof(header.magic));
+    header.version = MAP_CACHE_VERSION;
+    header.byteOrder = MAP_CACHE_BYTE_ORDER;
+    header.metaOffset = appendSection(blob, meta);
+    header.metaSize = quint32(meta.size());
+    std::memcpy(blob.data(), &header, sizeof(header));
+
+    QString cachePath = cacheFilePath(relativePath);
+    QDir().mkpath(QFileInfo(cachePath).path());
+
+    // Write atomically so a crash never leaves a truncated cache behind
+    QSaveFile file(cachePath);
+    if (!file.open(QIODevice::WriteOnly) || file.write(blob) != blob.size() || !file.commit()) {
+        qDebug() << "MapCache: Failed to write" << cachePath;
+        return false;
+    }
+
+    qDebug() << "MapCache: Compiled" << relativePath << "to" << cachePath << "(" << blob.size() << "bytes)";
+    return true;
+}
+
+bool MapCache::load(TmxMap& map, const QString& relativePath)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QString cachePath = cacheFilePath(relativePath);
+    QSharedPointer<QFile> file(new QFile(cachePath));
+    if (!file->open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    qint64 fileSize = file->size();
+    if (fileSize < qint64(sizeof(MapCacheHeader))) {
+        return false;
+    }
+
+    const uchar* data = file->map(0, fileSize);
+    if (!data) {
+        qDebug() << "MapCache: Failed to map" << cachePath;
+        return false;
+    }
+    StartupProfiler::countFile(fileSize);
+
+    MapCacheHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, MAP_CACHE_MAGIC, sizeof(header.magic)) != 0
+        || header.version != MAP_CACHE_VERSION
+        || header.byteOrder != MAP_CACHE_BYTE_ORDER
+        || qint64(header.metaOffset) + header.metaSize > fileSize) {
+        qDebug() << "MapCache: Ignoring incompatible cache" << cachePath;
+        return false;
+    }
+
+    bool valid = true;
+    auto view = [&](quint32 offset, quint32 size) {
+        if (qint64(offset) + size > fileSize) {
+            valid = false;
+            return QByteArray();
+        }
+        return QByteArray::fromRawData(reinterpret_cast<const char*>(data + offset), int(size));
+    };
+
+    QByteArray meta = view(header.metaOffset, header.metaSize);
+    QDataStream in(meta);
+    in.setVersion(QDataStream::Qt_5_15);
+
+    TmxMap result;
+
+    // Any change to the map or one of its tilesets invalidates the cache
+    quint32 sourceCount = 0;
+    in >> sourceCount;
+    for (quint32 i = 0; i < sourceCount && in.status() == QDataStream::Ok; ++i) {
+        QString source;
+        qint64 modified = 0;
+        qint64 size = 0;
+        in >> source >> modified >> size;
+
+        qint64 currentModified = 0;
+        qint64 currentSize = 0;
+        if (!ResourceLoader::fileStamp(source, currentModified, currentSize)
+            || currentModified != modified || currentSize != size) {
+            qDebug() << "MapCache: Cache is stale," << source << "changed";
+            return false;
+        }
+        result.sourceFiles.append(source);
+    }
+
+    qint32 width = 0, height = 0, tileWidth = 0, tileHeight = 0;
+    quint32 collisionOffset = 0, farmableOffset = 0, maskSize = 0;
+    in >> width >> height >> tileWidth >> tileHeight;
+    in >> result.hasFarmableLayer >> collisionOffset >> farmableOffset >> maskSize;
+    result.width = width;
+    result.height = height;
+    result.tileWidth = tileWidth;
+    result.tileHeight = tileHeight;
+    result.collisionMask = view(collisionOffset, maskSize);
+    result.farmableMask = view(farmableOffset, maskSize);
+
+    quint32 layerCount = 0;
+    in >> layerCount;
+    for (quint32 i = 0; i < layerCount && in.status() == QDataStream::Ok; ++i) {
+        TmxLayer layer;
+        qint32 layerWidth = 0, layerHeight = 0;
+        quint32 tileOffset = 0, tileBytes = 0;
+        in >> layer.name >> layerWidth >> layerHeight >> layer.visible >> tileOffset >> tileBytes;
+        layer.width = layerWidth;
+        layer.height = layerHeight;
+        if (tileBytes != quint32(layerWidth * layerHeight) * sizeof(quint16)) {
+            valid = false;
+        }
+        layer.tiles = view(tileOffset, tileBytes);
+        result.layers.append(layer);
+    }
+
+    quint32 groupCount = 0;
+    in >> groupCount;
+    for (quint32 i = 0; i < groupCount && in.status() == QDataStream::Ok; ++i) {
+        TmxObjectGroup group;
+        quint32 objectCount = 0;
+        in >> group.name >> objectCount;
+        for (quint32 j = 0; j < objectCount && in.status() == QDataStream::Ok; ++j) {
+            TmxObject object;
+            qint32 id = 0, gid = 0;
+            in >> id >> gid >> object.name >> object.type >> object.bounds;
+            object.id = id;
+            object.gid = gid;
+            group.objects.append(object);
+        }
+        result.objectGroups.append(group);
+    }
+
+    quint32 tilesetCount = 0;
+    in >> tilesetCount;
+    for (quint32 i = 0; i < tilesetCount && in.status() == QDataStream::Ok; ++i) {
+        TmxTileset tileset;
+        qint32 firstGid = 0, columns = 0;
+        in >> firstGid >> tileset.source >> columns >> tileset.imageSource >> tileset.tileImages;
+        tileset.firstGid = firstGid;
+        tileset.columns = columns;
+        result.tilesets.append(tileset);
+    }
+
+    if (!valid || in.status() != QDataStream::Ok
+        || result.collisionMask.size() < (width * height + 7) / 8) {
+        qDebug() << "MapCache: Ignoring corrupt cache" << cachePath;
+        return false;
+    }
+
+    // Layers and masks point into the mapping, so the map keeps the file open
+    result.backingFile = file;
+    map = result;
+
+    qDebug() << "MapCache: Loaded" << relativePath << "from cache in" << timer.elapsed() << "ms";
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+#ifndef MAPCACHE_H
+#define MAPCACHE_H
+
+#include <QString>
+
+class TmxMap;
+
+// Bump whenever the on-disk layout changes
+const quint32 MAP_CACHE_VERSION = 1;
+
+// Compiled binary form of a TMX map and its tilesets.
+//
+// Layout: a fixed header, then 8-byte aligned sections holding the packed
+// quint16 tile layers and the collision/farmable bitsets, then a metadata
+// block (sources, layer table, objects, tilesets). The file is mapped with
+// QFile::map and the tile sections are used in place without copying.
+class MapCache
+{
+public:
+    // Fill the map from its cache; fails if the cache is missing, from another
+    // version, or older than any of the files it was compiled from
+    static bool load(TmxMap& map, const QString& relativePath);
+
+    // Compile a parsed map into its cache file
+    static bool save(const TmxMap& map, const QString& relativePath);
+
+    static QString cacheFilePath(const QString& relativePath);
+};
+
+#endif // MAPCACHE_H
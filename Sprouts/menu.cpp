@@ -5,7 +5,7 @@
 #include <QKeyEvent>
 #include <QtMath>
 
-Menu::Menu(Player* player, std::function<void()> toggleMenu, std::function<void()> triggerSuccessEnding, QObject *parent)
+Menu::Menu(Player* player, TimerWheel* timerWheel, std::function<void()> toggleMenu, std::function<void()> triggerSuccessEnding, QObject *parent)
     : QObject{parent}, player(player), toggleMenu(toggleMenu), triggerSuccessEnding(triggerSuccessEnding)
 {
     font = QFont("Arial", 16, QFont::Bold);
@@ -35,7 +35,7 @@ Menu::Menu(Player* player, std::function<void()> toggleMenu, std::function<void(
     index = 0;
     
     // Setup input timer
-    timer = new GameTimer(200, nullptr, this); // 200ms cooldown
+    timer.setup(timerWheel, 200); // 200ms cooldown
 }
 
 void Menu::setupMenuOptions()
@@ -130,35 +130,30 @@ void Menu::displayEntry(QPainter& painter, int index)
     painter.drawText(entryRect, Qt::AlignLeft | Qt::AlignVCenter, displayText);
 }
 
-void Menu::update(float dt)
-{
-    timer->update();
-}
-
 void Menu::handleInput(const QList<int>& pressedKeys)
 {
-    if (timer->isActive()) return;
+    if (timer.isActive()) return;
     
     // Navigate menu
     if (pressedKeys.contains(Qt::Key_Up) || pressedKeys.contains(Qt::Key_W)) {
         index = (index - 1 + options.size()) % options.size();
-        timer->activate();
+        timer.activate();
     }
     else if (pressedKeys.contains(Qt::Key_Down) || pressedKeys.contains(Qt::Key_S)) {
         index = (index + 1) % options.size();
-        timer->activate();
+        timer.activate();
     }
     else if (pressedKeys.contains(Qt::Key_Space)) {
         // Execute current option
         executeCurrentOption();
-        timer->activate();
+        timer.activate();
     }
     else if (pressedKeys.contains(Qt::Key_Escape)) {
         // Close menu
         if (toggleMenu) {
             toggleMenu();
         }
-        timer->activate();
+        timer.activate();
     }
 }
 
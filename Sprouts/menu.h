@@ -17,10 +17,9 @@ class Menu : public QObject
     Q_OBJECT
 
 public:
-    explicit Menu(Player* player, std::function<void()> toggleMenu, std::function<void()> triggerSuccessEnding = nullptr, QObject *parent = nullptr);
+    explicit Menu(Player* player, TimerWheel* timerWheel, std::function<void()> toggleMenu, std::function<void()> triggerSuccessEnding = nullptr, QObject *parent = nullptr);
     
-    // Update and display menu
-    void update(float dt);
+    // Display menu
     void display(QPainter& painter);
     void handleInput(const QList<int>& pressedKeys);
     
@@ -51,7 +50,7 @@ private:
     int index;
     
     // Timer for input
-    GameTimer* timer;
+    GameTimer timer;
     
     // Helper methods
     void setupMenuOptions();
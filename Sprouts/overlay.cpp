@@ -1,7 +1,9 @@
 #include "overlay.h"
 #include "player.h"
 #include "level.h"
+#include "triggersystem.h"
 #include "resourceloader.h"
+#include "startupprofiler.h"
 #include "gamesettings.h"
 #include <QPainter>
 #include <QDebug>
@@ -14,6 +16,8 @@ Overlay::Overlay(Player* player, QObject *parent)
 
 void Overlay::loadGraphics()
 {
+    StartupProfiler::Scope scope("Overlay::loadGraphics");
+
     // Load tool graphics
     QStringList toolNames = {"hoe", "axe", "water"};
     for (const QString& tool : toolNames) {
@@ -44,6 +48,7 @@ void Overlay::display(QPainter& painter)
     displayEnergy(painter);
     displayTime(painter);
     displayWeather(painter);
+    displayPrompt(painter);
 }
 
 void Overlay::displayTools(QPainter& painter)
@@ -51,12 +56,13 @@ void Overlay::displayTools(QPainter& painter)
     if (!player) return;
     
     // Get current tool
-    QString currentTool = player->selectedTool;
+    ToolType currentTool = player->selectedTool;
     
     // Tool overlay positions
     QPoint toolPos(40, 40);
     int spacing = 80;
     
+    // In ToolType order
     QStringList tools = {"hoe", "axe", "water"};
     
     for (int i = 0; i < tools.size(); ++i) {
@@ -65,7 +71,7 @@ void Overlay::displayTools(QPainter& painter)
         
         // Draw tool background
         QRect bgRect(pos.x() - 5, pos.y() - 5, 70, 70);
-        if (tool == currentTool) {
+        if (i == currentTool) {
             painter.fillRect(bgRect, QColor(255, 255, 255, 100));
         } else {
             painter.fillRect(bgRect, QColor(100, 100, 100, 50));
@@ -308,4 +314,35 @@ void Overlay::displayWeather(QPainter& painter)
     painter.setPen(Qt::white);
     QPointF weatherPos(bgX + 10, bgY + bgHeight - 5);
     painter.drawText(weatherPos, weatherText);
+}
+
+void Overlay::displayPrompt(QPainter& painter)
+{
+    if (!player || !player->level || !player->level->triggers) return;
+    
+    // Read the zones the player is currently standing in
+    TriggerSystem* triggers = player->level->triggers;
+    if (triggers->empty()) return;
+    
+    QString promptText = triggers->zoneNamed("Trader") ? "按回车键交易" : "按回车键睡觉";
+    
+    // Calculate text size for centering
+    painter.setFont(QFont("Arial", 12, QFont::Bold));
+    QFontMetrics fm(painter.font());
+    int textWidth = fm.horizontalAdvance(promptText);
+    int textHeight = fm.height();
+    
+    // Position for prompt display (bottom center)
+    int bgX = (SCREEN_WIDTH - textWidth) / 2 - 10;
+    int bgY = SCREEN_HEIGHT - 80;
+    int bgWidth = textWidth + 20;
+    int bgHeight = textHeight + 10;
+    
+    // Draw background
+    painter.fillRect(bgX, bgY, bgWidth, bgHeight, QColor(0, 0, 0, 100));
+    
+    // Draw prompt text (centered in background)
+    painter.setPen(Qt::white);
+    QPointF promptPos(bgX + 10, bgY + bgHeight - 5);
+    painter.drawText(promptPos, promptText);
 }
\ No newline at end of file
@@ -19,6 +19,9 @@ public:
     // Display overlay
     void display(QPainter& painter);
     
+    // Reload tool and seed icons (hot reload)
+    void reloadGraphics() { loadGraphics(); }
+    
 private:
     void displayTools(QPainter& painter);
     void displaySeeds(QPainter& painter);
@@ -27,6 +30,7 @@ private:
     void displayEnergy(QPainter& painter);
     void displayTime(QPainter& painter);
     void displayWeather(QPainter& painter);
+    void displayPrompt(QPainter& painter);
     Player* player;
     
     // Tool and seed surfaces
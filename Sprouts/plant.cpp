@@ -6,9 +6,9 @@
 #include <QDir>
 
 Plant::Plant(const QString& plantType, QVector<SpriteGroup*> groups, 
-             Sprite* soil, std::function<bool(const QPointF&)> checkWatered, 
-             QObject *parent)
-    : Sprite(parent), plantType(plantType), soil(soil), checkWatered(checkWatered),
+             SpriteHandle soil, EntityRegistry* entities,
+             std::function<bool(const QPointF&)> checkWatered)
+    : Sprite(), plantType(plantType), soil(soil), entities(entities), checkWatered(checkWatered),
       age(0), harvestable(false)
 {
     // Load all growth frames
@@ -38,8 +38,8 @@ Plant::Plant(const QString& plantType, QVector<SpriteGroup*> groups,
     z = GROUND_PLANT;
     
     // Position relative to soil center
-    if (soil) {
-        QPoint soilCenter = soil->rect.center();
+    if (Sprite* soilSprite = entities->get(soil)) {
+        soilCenter = soilSprite->rect.center();
         rect = QRect(soilCenter + QPoint(-image.width() / 2, -image.height() / 2 + yOffset), image.size());
     }
     
@@ -48,6 +48,9 @@ Plant::Plant(const QString& plantType, QVector<SpriteGroup*> groups,
         addToGroup(group);
     }
     
+    // Grows while watered; SoilLayer wakes it again after watering
+    setTicking(true);
+    
     qDebug() << "Plant: Created" << plantType << "at" << rect.topLeft() << "with" << frames.size() << "frames";
 }
 
@@ -72,7 +75,8 @@ void Plant::loadFrames()
 void Plant::grow()
 {
     if (!checkWatered || !checkWatered(rect.center())) {
-        return; // Can't grow without water
+        setTicking(false); // Can't grow without water
+        return;
     }
     
     age += growSpeed;
@@ -92,6 +96,7 @@ void Plant::grow()
     if (age >= maxAge) {
         age = maxAge;
         harvestable = true;
+        setTicking(false);
     }
     
     updateImage();
@@ -104,8 +109,10 @@ void Plant::updateImage()
         image = frames[frameIndex];
         
         // Update position relative to soil center
-        if (soil) {
-            QPoint soilCenter = soil->rect.center();
+        if (Sprite* soilSprite = entities->get(soil)) {
+            soilCenter = soilSprite->rect.center();
+        }
+        if (!soil.isNull()) {
             rect = QRect(soilCenter + QPoint(-image.width() / 2, -image.height() / 2 + yOffset), image.size());
         }
     }
@@ -2,7 +2,6 @@
 #define PLANT_H
 
 #include "sprite.h"
-#include <QObject>
 #include <QPixmap>
 #include <QVector>
 #include <QPoint>
@@ -14,17 +13,19 @@ class SoilLayer;
 
 class Plant : public Sprite
 {
-    Q_OBJECT
-
 public:
-    explicit Plant(const QString& plantType, QVector<SpriteGroup*> groups, 
-                   Sprite* soil, std::function<bool(const QPointF&)> checkWatered, 
-                   QObject *parent = nullptr);
+    Plant(const QString& plantType, QVector<SpriteGroup*> groups, 
+          SpriteHandle soil, EntityRegistry* entities,
+          std::function<bool(const QPointF&)> checkWatered);
     
     // Plant properties
     QString plantType;
     QVector<QPixmap> frames;
-    Sprite* soil;
+    // Soil tiles are rebuilt whenever the farm changes, so the handle can go
+    // stale; the plant then stays where it was planted
+    SpriteHandle soil;
+    EntityRegistry* entities;
+    QPoint soilCenter;
     std::function<bool(const QPointF&)> checkWatered;
     
     // Growth properties
@@ -2,27 +2,27 @@
 #include "spritegroup.h"
 #include "resourceloader.h"
 #include "tree.h"
+#include "triggersystem.h"
 #include <QKeyEvent>
 #include <QDebug>
 #include <QtMath>
 #include <QUrl>
 
 Player::Player(const QPointF& pos, SpriteGroup* group, 
-               SpriteGroup* collisionSprites, SpriteGroup* treeSprites,
-               SpriteGroup* interactionSprites, SoilLayer* soilLayer,
+               SpriteGroup* collisionSprites, TypedGroup<Tree>* treeSprites,
+               TriggerSystem* triggers, SoilLayer* soilLayer, TimerWheel* timerWheel,
                std::function<void()> toggleShop, QObject *parent)
-    : Sprite(parent), status("down_idle"), frameIndex(0), direction(0, 0), 
-      speed(200), toolIndex(0), seedIndex(0), money(200), energy(100), maxEnergy(100), sleep(false),
+    : QObject(parent), Sprite(), status(DOWN_IDLE), frameIndex(0), direction(0, 0), 
+      speed(200), selectedTool(HOE), seedIndex(0), money(200), energy(100), maxEnergy(100), sleep(false),
+      clips("graphics/character", PLAYER_STATUS_NAMES),
       collisionSprites(collisionSprites), treeSprites(treeSprites),
-      interactionSprites(interactionSprites), soilLayer(soilLayer),
+      triggers(triggers), soilLayer(soilLayer),
       toggleShop(toggleShop)
 {
-    // Import assets
-    importAssets();
-    
     // Setup initial state
-    if (animations.contains(status) && !animations[status].isEmpty()) {
-        image = animations[status][0];
+    const QVector<QPixmap>& initialFrames = clips.frames(status);
+    if (!initialFrames.isEmpty()) {
+        image = initialFrames[0];
     } else {
         // Create a placeholder image if no animation is found
         image = QPixmap(64, 64);
@@ -41,10 +41,7 @@ Player::Player(const QPointF& pos, SpriteGroup* group,
                    rect.y() + rect.height() - hitboxHeight,
                    hitboxWidth, hitboxHeight);
     
-    // Setup tools and seeds
-    tools = {"hoe", "axe", "water"};
-    selectedTool = tools[toolIndex];
-    
+    // Setup seeds
     seeds = {"corn", "tomato"};
     selectedSeed = seeds[seedIndex];
     
@@ -58,7 +55,7 @@ Player::Player(const QPointF& pos, SpriteGroup* group,
     seedInventory["tomato"] = 5;
     
     // Setup timers
-    setupTimers();
+    setupTimers(timerWheel);
     
     // Setup sound
     wateringSound = new QSoundEffect(this);
@@ -66,22 +63,23 @@ Player::Player(const QPointF& pos, SpriteGroup* group,
     wateringSound->setSource(QUrl::fromLocalFile(waterPath));
     wateringSound->setVolume(0.2);
     
-    // Add to group
+    // Add to group; the player is updated every frame
     if (group) {
         addToGroup(group);
     }
+    setTicking(true);
     
     // Check for initial collision and adjust position if needed
     checkInitialPosition();
 }
 
-void Player::setupTimers()
+void Player::setupTimers(TimerWheel* timerWheel)
 {
-    timers["tool use"] = new GameTimer(350, [this]() { useTool(); }, this);
-    timers["tool switch"] = new GameTimer(200, nullptr, this);
-    timers["seed use"] = new GameTimer(350, [this]() { useSeed(); }, this);
-    timers["seed switch"] = new GameTimer(200, nullptr, this);
-    timers["interaction"] = new GameTimer(300, nullptr, this);
+    timers[TOOL_USE].setup(timerWheel, 350, [this]() { useTool(); });
+    timers[TOOL_SWITCH].setup(timerWheel, 200);
+    timers[SEED_USE].setup(timerWheel, 350, [this]() { useSeed(); });
+    timers[SEED_SWITCH].setup(timerWheel, 200);
+    timers[INTERACTION].setup(timerWheel, 300);
 }
 
 void Player::checkInitialPosition()
@@ -151,39 +149,24 @@ void Player::checkInitialPosition()
     qDebug() << "Player: Warning - Could not find collision-free position, staying at" << pos;
 }
 
-void Player::importAssets()
-{
-    QStringList animationTypes = {
-        "up", "down", "left", "right",
-        "right_idle", "left_idle", "up_idle", "down_idle",
-        "right_hoe", "left_hoe", "up_hoe", "down_hoe",
-        "right_axe", "left_axe", "up_axe", "down_axe",
-        "right_water", "left_water", "up_water", "down_water"
-    };
-    
-    for (const QString& animationType : animationTypes) {
-        QString fullPath = QString("graphics/character/%1").arg(animationType);
-        animations[animationType] = ResourceLoader::importFolder(fullPath);
-    }
-}
-
 void Player::animate(float dt)
 {
-    if (!animations.contains(status) || animations[status].isEmpty()) {
+    const QVector<QPixmap>& frames = clips.frames(status);
+    if (frames.isEmpty()) {
         return;
     }
     
     frameIndex += 4.0f * dt;
-    if (frameIndex >= animations[status].size()) {
+    if (frameIndex >= frames.size()) {
         frameIndex = 0;
     }
     
-    image = animations[status][static_cast<int>(frameIndex)];
+    image = frames[static_cast<int>(frameIndex)];
 }
 
 void Player::handleInput(const QList<int>& pressedKeys)
 {
-    if (timers["tool use"]->isActive() || sleep) {
+    if (timers[TOOL_USE].isActive() || sleep) {
         return;
     }
     
@@ -195,65 +178,58 @@ void Player::handleInput(const QList<int>& pressedKeys)
     // Movement input
     if (pressedKeys.contains(Qt::Key_Up)) {
         direction.setY(-1);
-        status = "up";
+        status = UP;
     } else if (pressedKeys.contains(Qt::Key_Down)) {
         direction.setY(1);
-        status = "down";
+        status = DOWN;
     }
     
     if (pressedKeys.contains(Qt::Key_Right)) {
         direction.setX(1);
-        status = "right";
+        status = RIGHT;
     } else if (pressedKeys.contains(Qt::Key_Left)) {
         direction.setX(-1);
-        status = "left";
+        status = LEFT;
     }
     
     // Tool use
     if (pressedKeys.contains(Qt::Key_Space)) {
-        timers["tool use"]->activate();
+        timers[TOOL_USE].activate();
         direction = QPointF(0, 0);
         frameIndex = 0;
     }
     
     // Change tool
-    if (pressedKeys.contains(Qt::Key_Q) && !timers["tool switch"]->isActive()) {
-        timers["tool switch"]->activate();
-        toolIndex = (toolIndex + 1) % tools.size();
-        selectedTool = tools[toolIndex];
+    if (pressedKeys.contains(Qt::Key_Q) && !timers[TOOL_SWITCH].isActive()) {
+        timers[TOOL_SWITCH].activate();
+        selectedTool = ToolType((selectedTool + 1) % TOOL_COUNT);
     }
     
     // Seed use
     if (pressedKeys.contains(Qt::Key_Control)) {
-        timers["seed use"]->activate();
+        timers[SEED_USE].activate();
         direction = QPointF(0, 0);
         frameIndex = 0;
     }
     
     // Change seed
-    if (pressedKeys.contains(Qt::Key_E) && !timers["seed switch"]->isActive()) {
-        timers["seed switch"]->activate();
+    if (pressedKeys.contains(Qt::Key_E) && !timers[SEED_SWITCH].isActive()) {
+        timers[SEED_SWITCH].activate();
         seedIndex = (seedIndex + 1) % seeds.size();
         selectedSeed = seeds[seedIndex];
     }
     
     // Interaction
-    if (pressedKeys.contains(Qt::Key_Return) && !timers["interaction"]->isActive()) {
-        // Check for interaction sprites collision
-        if (interactionSprites) {
-            for (Sprite* sprite : interactionSprites->sprites()) {
-                Interaction* interaction = qobject_cast<Interaction*>(sprite);
-                if (interaction && interaction->rect.intersects(rect)) {
-                    if (interaction->name == "Trader") {
-                        toggleShop();
-                        timers["interaction"]->activate();
-                    } else {
-                        status = "left_idle";
-                        sleep = true;
-                        timers["interaction"]->activate();
-                    }
-                    break;
-                }
+    if (pressedKeys.contains(Qt::Key_Return) && !timers[INTERACTION].isActive()) {
+        // The trigger system already knows which zones we are standing in
+        if (triggers && !triggers->empty()) {
+            if (triggers->zoneNamed("Trader")) {
+                toggleShop();
+                timers[INTERACTION].activate();
+            } else {
+                status = LEFT_IDLE;
+                sleep = true;
+                timers[INTERACTION].activate();
             }
         }
     }
@@ -268,24 +244,23 @@ void Player::useTool()
     
     getTargetPos();
     
-    if (selectedTool == "hoe") {
+    if (selectedTool == HOE) {
         if (soilLayer) {
             soilLayer->getHit(targetPos);
             decreaseEnergy(1); // Using hoe consumes 1 energy
         }
-    } else if (selectedTool == "axe") {
+    } else if (selectedTool == AXE) {
         // Check tree collision
         if (treeSprites) {
-            for (Sprite* sprite : treeSprites->sprites()) {
-                Tree* tree = qobject_cast<Tree*>(sprite);
-                if (tree && tree->rect.contains(targetPos.toPoint())) {
+            for (Tree* tree : *treeSprites) {
+                if (tree->rect.contains(targetPos.toPoint())) {
                     tree->damage();
                     decreaseEnergy(2); // Using axe consumes 2 energy
                     break;
                 }
             }
         }
-    } else if (selectedTool == "water") {
+    } else if (selectedTool == WATER_TOOL) {
         if (soilLayer) {
             soilLayer->water(targetPos);
             decreaseEnergy(1); // Using water consumes 1 energy
@@ -311,45 +286,26 @@ void Player::useSeed()
 
 void Player::getTargetPos()
 {
-    QString direction = getDirectionFromStatus();
-    if (PLAYER_TOOL_OFFSET.contains(direction)) {
-        targetPos = QPointF(rect.center()) + PLAYER_TOOL_OFFSET[direction];
-    } else {
-        targetPos = QPointF(rect.center());
-    }
-}
-
-QString Player::getDirectionFromStatus() const
-{
-    if (status.contains("_")) {
-        return status.split("_")[0];
-    }
-    return status;
+    targetPos = QPointF(rect.center()) + PLAYER_TOOL_OFFSET[statusDirection(status)];
 }
 
 void Player::getStatus()
 {
+    // Facing is kept; the action follows movement and tool use
+    Direction facing = statusDirection(status);
+    
     // Idle status
     if (qFuzzyIsNull(direction.x()) && qFuzzyIsNull(direction.y())) {
-        QString baseDirection = getDirectionFromStatus();
-        status = baseDirection + "_idle";
+        status = playerStatus(facing, ACTION_IDLE);
     }
     
     // Tool use status
-    if (timers["tool use"]->isActive()) {
-        QString baseDirection = getDirectionFromStatus();
-        status = baseDirection + "_" + selectedTool;
-    }
-}
-
-void Player::updateTimers()
-{
-    for (GameTimer* timer : timers.values()) {
-        timer->update();
+    if (timers[TOOL_USE].isActive()) {
+        status = playerStatus(facing, toolAction(selectedTool));
     }
 }
 
-void Player::collision(const QString& direction)
+void Player::collision(Axis axis)
 {
     // Check collision sprites only - let TMX collision data define all boundaries
     if (!collisionSprites) {
@@ -357,28 +313,28 @@ void Player::collision(const QString& direction)
     }
     
     // Only check collision if actually moving in the specified direction
-    if (direction == "horizontal" && qFuzzyIsNull(this->direction.x())) {
+    if (axis == Horizontal && qFuzzyIsNull(direction.x())) {
         return;
     }
-    if (direction == "vertical" && qFuzzyIsNull(this->direction.y())) {
+    if (axis == Vertical && qFuzzyIsNull(direction.y())) {
         return;
     }
     
     for (Sprite* sprite : collisionSprites->sprites()) {
         if (sprite->hitbox.intersects(hitbox)) {
-            if (direction == "horizontal") {
-                if (this->direction.x() > 0) { // moving right
+            if (axis == Horizontal) {
+                if (direction.x() > 0) { // moving right
                     hitbox.moveRight(sprite->hitbox.left() - 1);
-                } else if (this->direction.x() < 0) { // moving left
+                } else if (direction.x() < 0) { // moving left
                     hitbox.moveLeft(sprite->hitbox.right() + 1);
                 }
                 rect.moveCenter(hitbox.center());
                 pos = QPointF(rect.center());
                 break; // Exit after first collision to prevent multiple adjustments
-            } else if (direction == "vertical") {
-                if (this->direction.y() > 0) { // moving down
+            } else {
+                if (direction.y() > 0) { // moving down
                     hitbox.moveBottom(sprite->hitbox.top() - 1);
-                } else if (this->direction.y() < 0) { // moving up
+                } else if (direction.y() < 0) { // moving up
                     hitbox.moveTop(sprite->hitbox.bottom() + 1);
                 }
                 rect.moveCenter(hitbox.center());
@@ -403,18 +359,17 @@ void Player::move(float dt)
     pos.setX(pos.x() + direction.x() * speed * dt);
     hitbox.moveCenter(QPoint(qRound(pos.x()), hitbox.center().y()));
     rect.moveCenter(hitbox.center());
-    collision("horizontal");
+    collision(Horizontal);
     
     // Vertical movement
     pos.setY(pos.y() + direction.y() * speed * dt);
     hitbox.moveCenter(QPoint(hitbox.center().x(), qRound(pos.y())));
     rect.moveCenter(hitbox.center());
-    collision("vertical");
+    collision(Vertical);
 }
 
 void Player::update(float dt)
 {
-    updateTimers();
     getStatus();
     move(dt);
     animate(dt);
@@ -11,21 +11,24 @@
 #include <QSoundEffect>
 #include <functional>
 #include "sprite.h"
+#include "spritegroup.h"
 #include "gametimer.h"
+#include "animationclips.h"
 #include "gamesettings.h"
 #include "soillayer.h"
 
-class SpriteGroup;
+class Tree;
 class Level;
+class TriggerSystem;
 
-class Player : public Sprite
+class Player : public QObject, public Sprite
 {
     Q_OBJECT
 
 public:
     explicit Player(const QPointF& pos, SpriteGroup* group, 
-                   SpriteGroup* collisionSprites, SpriteGroup* treeSprites,
-                   SpriteGroup* interactionSprites, SoilLayer* soilLayer,
+                   SpriteGroup* collisionSprites, TypedGroup<Tree>* treeSprites,
+                   TriggerSystem* triggers, SoilLayer* soilLayer, TimerWheel* timerWheel,
                    std::function<void()> toggleShop, QObject *parent = nullptr);
 
     // Core methods
@@ -34,8 +37,9 @@ public:
     void handleInput(const QList<int>& pressedKeys);
     
     // Movement
+    enum Axis { Horizontal, Vertical };
     void move(float dt);
-    void collision(const QString& direction);
+    void collision(Axis axis);
     
     // Tools and seeds
     void useTool();
@@ -44,17 +48,16 @@ public:
     
     // Status management
     void getStatus();
-    void updateTimers();
     
-    // Asset loading
-    void importAssets();
+    // Asset loading (hot reload)
+    void reloadClips() { clips.reload(); }
     
     // Energy management
     void restoreEnergy();
     void decreaseEnergy(int amount = 1);
     
     // Public properties
-    QString status;
+    PlayerStatus status;
     float frameIndex;
     QPointF direction;
     QPointF pos;
@@ -62,9 +65,7 @@ public:
     QPointF targetPos;
     
     // Tools and inventory
-    QVector<QString> tools;
-    int toolIndex;
-    QString selectedTool;
+    ToolType selectedTool;
     
     QVector<QString> seeds;
     int seedIndex;
@@ -88,17 +89,25 @@ signals:
     void playerAddItem(const QString& item);
     
 private:
-    // Animation frames
-    QMap<QString, QVector<QPixmap>> animations;
+    // Animation clips indexed by status; only the current one is held
+    AnimationClips clips;
     
     // Sprite groups
     SpriteGroup* collisionSprites;
-    SpriteGroup* treeSprites;
-    SpriteGroup* interactionSprites;
+    TypedGroup<Tree>* treeSprites;
+    TriggerSystem* triggers;
     SoilLayer* soilLayer;
     
-    // Timers
-    QMap<QString, GameTimer*> timers;
+    // Cooldowns on the level's timer wheel
+    enum PlayerTimer {
+        TOOL_USE,
+        TOOL_SWITCH,
+        SEED_USE,
+        SEED_SWITCH,
+        INTERACTION,
+        TIMER_COUNT
+    };
+    GameTimer timers[TIMER_COUNT];
     
     // Callbacks
     std::function<void()> toggleShop;
@@ -107,8 +116,7 @@ private:
     QSoundEffect* wateringSound;
     
     // Private helper methods
-    QString getDirectionFromStatus() const;
-    void setupTimers();
+    void setupTimers(TimerWheel* timerWheel);
     void checkInitialPosition();
 };
 
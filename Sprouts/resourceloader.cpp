@@ -1,8 +1,30 @@
 #include "resourceloader.h"
+#include "assetpack.h"
+#include "texturecache.h"
+#include "startupprofiler.h"
 #include <QDir>
+#include <QDirIterator>
+#include <QFile>
 #include <QFileInfo>
 #include <QDebug>
 #include <QCoreApplication>
+#include <QPair>
+#include <algorithm>
+
+QHash<QString, ResourceLoader::CachedImage> ResourceLoader::imageCache;
+QHash<QString, QStringList> ResourceLoader::folderListings;
+int ResourceLoader::cacheHits = 0;
+int ResourceLoader::cacheMisses = 0;
+quint64 ResourceLoader::currentFrame = 1;
+qint64 ResourceLoader::imageBudget = DEFAULT_IMAGE_BUDGET;
+qint64 ResourceLoader::residentBytes = 0;
+qint64 ResourceLoader::peakResidentBytes = 0;
+double ResourceLoader::residentBytesSum = 0;
+quint64 ResourceLoader::sampledFrames = 0;
+int ResourceLoader::evictions = 0;
+QString ResourceLoader::resolvedRoot;
+QHash<QString, QString> ResourceLoader::resolvedPaths;
+AssetPack* ResourceLoader::pack = nullptr;
 
 ResourceLoader::ResourceLoader(QObject *parent)
     : QObject{parent}
@@ -13,25 +35,8 @@ QVector<QPixmap> ResourceLoader::importFolder(const QString& path)
 {
     QVector<QPixmap> surfaceList;
     
-    // Convert relative path to absolute path from source directory
-    QString absolutePath = getResourcePath(path);
-    QDir dir(absolutePath);
-    
-    if (!dir.exists()) {
-        qDebug() << "Directory does not exist:" << absolutePath;
-        return surfaceList;
-    }
-    
-    QStringList filters;
-    filters << "*.png" << "*.jpg" << "*.jpeg" << "*.bmp";
-    dir.setNameFilters(filters);
-    dir.setSorting(QDir::Name);
-    
-    QStringList imageFiles = dir.entryList(QDir::Files);
-    
-    for (const QString& imageFile : imageFiles) {
-        QString fullPath = dir.absoluteFilePath(imageFile);
-        QPixmap pixmap(fullPath);
+    for (const QString& fullPath : imageFiles(path)) {
+        QPixmap pixmap = cachedPixmap(fullPath);
         
         if (!pixmap.isNull()) {
             surfaceList.append(pixmap);
@@ -47,47 +52,289 @@ QMap<QString, QPixmap> ResourceLoader::importFolderDict(const QString& path)
 {
     QMap<QString, QPixmap> surfaceDict;
     
+    for (const QString& fullPath : imageFiles(path)) {
+        QPixmap pixmap = cachedPixmap(fullPath);
+        
+        if (!pixmap.isNull()) {
+            QString baseName = QFileInfo(fullPath).baseName();
+            surfaceDict[baseName] = pixmap;
+        } else {
+            qDebug() << "Failed to load image:" << fullPath;
+        }
+    }
+    
+    return surfaceDict;
+}
+
+QStringList ResourceLoader::imageFiles(const QString& path, bool recursive)
+{
+    // Listings are stable for the lifetime of the process
+    QString listingKey = recursive ? path + "/**" : path;
+    auto cached = folderListings.constFind(listingKey);
+    if (cached != folderListings.constEnd()) {
+        return cached.value();
+    }
+    
+    QStringList result = listFolder(path, recursive);
+    folderListings.insert(listingKey, result);
+    return result;
+}
+
+QStringList ResourceLoader::listFolder(const QString& path, bool recursive)
+{
+    QStringList result;
+    QStringList suffixes;
+    suffixes << "png" << "jpg" << "jpeg" << "bmp";
+    
+    // Prefer the pack's index over listing the directory
+    if (pack) {
+        for (const QString& entry : pack->entries(path, recursive)) {
+            if (suffixes.contains(QFileInfo(entry).suffix().toLower())) {
+                result.append(getResourcePath(entry));
+            }
+        }
+        if (!result.isEmpty()) {
+            return result;
+        }
+    }
+    
     // Convert relative path to absolute path from source directory
     QString absolutePath = getResourcePath(path);
     QDir dir(absolutePath);
     
     if (!dir.exists()) {
         qDebug() << "Directory does not exist:" << absolutePath;
-        return surfaceDict;
+        return result;
     }
     
     QStringList filters;
-    filters << "*.png" << "*.jpg" << "*.jpeg" << "*.bmp";
-    dir.setNameFilters(filters);
-    
-    QStringList imageFiles = dir.entryList(QDir::Files);
+    for (const QString& suffix : suffixes) {
+        filters << "*." + suffix;
+    }
     
-    for (const QString& imageFile : imageFiles) {
-        QString fullPath = dir.absoluteFilePath(imageFile);
-        QPixmap pixmap(fullPath);
-        
-        if (!pixmap.isNull()) {
-            QString baseName = QFileInfo(imageFile).baseName();
-            surfaceDict[baseName] = pixmap;
-        } else {
-            qDebug() << "Failed to load image:" << fullPath;
-        }
+    QDirIterator it(absolutePath, filters, QDir::Files,
+                    recursive ? QDirIterator::Subdirectories : QDirIterator::NoIteratorFlags);
+    while (it.hasNext()) {
+        result.append(it.next());
     }
     
-    return surfaceDict;
+    result.sort();
+    return result;
 }
 
 QPixmap ResourceLoader::loadImage(const QString& path)
 {
     // Convert relative path to absolute path from source directory
     QString absolutePath = getResourcePath(path);
-    QPixmap pixmap(absolutePath);
+    QPixmap pixmap = cachedPixmap(absolutePath);
     if (pixmap.isNull()) {
         qDebug() << "Failed to load image:" << absolutePath;
     }
     return pixmap;
 }
 
+QPixmap ResourceLoader::cachedPixmap(const QString& absolutePath)
+{
+    auto it = imageCache.find(absolutePath);
+    if (it != imageCache.end()) {
+        cacheHits++;
+        it->lastUsedFrame = currentFrame;
+        return it->pixmap;
+    }
+    
+    // Failed loads are cached too so a missing file is not probed again every frame
+    cacheMisses++;
+    QPixmap pixmap = QPixmap::fromImage(decodeImage(absolutePath));
+    insertResident(absolutePath, pixmap, currentFrame);
+    enforceBudget();
+    return pixmap;
+}
+
+void ResourceLoader::insertResident(const QString& absolutePath, const QPixmap& pixmap, quint64 frame)
+{
+    CachedImage entry;
+    entry.pixmap = pixmap;
+    entry.bytes = qint64(pixmap.width()) * pixmap.height() * pixmap.depth() / 8;
+    entry.lastUsedFrame = frame;
+    
+    auto existing = imageCache.constFind(absolutePath);
+    if (existing != imageCache.constEnd()) {
+        residentBytes -= existing->bytes;
+    }
+    imageCache.insert(absolutePath, entry);
+    residentBytes += entry.bytes;
+}
+
+void ResourceLoader::enforceBudget()
+{
+    if (residentBytes <= imageBudget) {
+        return;
+    }
+    
+    // Only images nobody else holds a handle to, and that were not used this frame
+    QVector<QPair<quint64, QString>> candidates;
+    for (auto it = imageCache.constBegin(); it != imageCache.constEnd(); ++it) {
+        if (it->lastUsedFrame < currentFrame && it->bytes > 0 && it->pixmap.isDetached()) {
+            candidates.append(qMakePair(it->lastUsedFrame, it.key()));
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    
+    // Least recently used first
+    for (const auto& candidate : candidates) {
+        if (residentBytes <= imageBudget) {
+            break;
+        }
+        residentBytes -= imageCache.value(candidate.second).bytes;
+        imageCache.remove(candidate.second);
+        evictions++;
+    }
+}
+
+void ResourceLoader::beginFrame()
+{
+    currentFrame++;
+    enforceBudget();
+    
+    // Image memory statistics
+    peakResidentBytes = qMax(peakResidentBytes, residentBytes);
+    residentBytesSum += residentBytes;
+    sampledFrames++;
+}
+
+void ResourceLoader::reportImageMemory()
+{
+    qint64 average = sampledFrames > 0 ? qint64(residentBytesSum / sampledFrames) : residentBytes;
+    qDebug() << "ResourceLoader: Image memory" << residentBytes / 1024 << "KiB resident,"
+             << peakResidentBytes / 1024 << "KiB peak," << average / 1024 << "KiB average over"
+             << sampledFrames << "frames," << evictions << "evictions, budget" << imageBudget / 1024 << "KiB";
+}
+
+QImage ResourceLoader::decodeImage(const QString& absolutePath)
+{
+    QString relativePath = packPath(absolutePath);
+    bool inPack = pack && pack->contains(relativePath);
+    
+    // Source stamp for the decoded texture cache
+    qint64 modified = 0;
+    qint64 size = 0;
+    bool cacheable = TextureCache::isEnabled();
+    if (cacheable) {
+        if (inPack) {
+            modified = pack->lastModified().toMSecsSinceEpoch();
+            size = pack->size(relativePath);
+        } else {
+            QFileInfo info(absolutePath);
+            cacheable = info.exists();
+            modified = info.lastModified().toMSecsSinceEpoch();
+            size = info.size();
+        }
+    }
+    
+    if (cacheable) {
+        QImage cached = TextureCache::load(relativePath, modified, size);
+        if (!cached.isNull()) {
+            StartupProfiler::countFile(cached.sizeInBytes());
+            return cached;
+        }
+    }
+    
+    StartupProfiler::countFile(inPack ? pack->size(relativePath) : QFileInfo(absolutePath).size());
+    QImage image = inPack ? QImage::fromData(pack->data(relativePath)) : QImage(absolutePath);
+    
+    if (cacheable && !image.isNull()) {
+        image = TextureCache::store(relativePath, modified, size, image);
+    }
+    return image;
+}
+
+QByteArray ResourceLoader::readFile(const QString& relativePath)
+{
+    if (pack) {
+        QByteArray bytes = pack->data(relativePath);
+        if (!bytes.isNull()) {
+            StartupProfiler::countFile(bytes.size());
+            return bytes;
+        }
+    }
+    
+    QFile file(getResourcePath(relativePath));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    QByteArray bytes = file.readAll();
+    StartupProfiler::countFile(bytes.size());
+    return bytes;
+}
+
+bool ResourceLoader::fileStamp(const QString& relativePath, qint64& modified, qint64& size)
+{
+    if (pack && pack->contains(relativePath)) {
+        modified = pack->lastModified().toMSecsSinceEpoch();
+        size = pack->size(relativePath);
+        return true;
+    }
+    
+    QFileInfo info(getResourcePath(relativePath));
+    if (!info.exists()) {
+        return false;
+    }
+    modified = info.lastModified().toMSecsSinceEpoch();
+    size = info.size();
+    return true;
+}
+
+bool ResourceLoader::openPack(const QString& packPath)
+{
+    closePack();
+    
+    AssetPack* candidate = new AssetPack();
+    if (!candidate->open(packPath)) {
+        delete candidate;
+        return false;
+    }
+    pack = candidate;
+    return true;
+}
+
+void ResourceLoader::closePack()
+{
+    delete pack;
+    pack = nullptr;
+}
+
+QString ResourceLoader::packPath(const QString& absolutePath)
+{
+    return QDir(assetRoot()).relativeFilePath(absolutePath);
+}
+
+void ResourceLoader::insertImage(const QString& absolutePath, const QPixmap& pixmap)
+{
+    // Preloaded images count as unused until first requested, so they are evicted
+    // first. The budget is not enforced here: that would rescan the cache for
+    // every delivered image and evict the one just inserted. The preloader stops
+    // inserting at the budget, and beginFrame() trims any overshoot.
+    insertResident(absolutePath, pixmap, 0);
+}
+
+void ResourceLoader::invalidateImage(const QString& absolutePath)
+{
+    auto it = imageCache.find(absolutePath);
+    if (it != imageCache.end()) {
+        residentBytes -= it->bytes;
+        imageCache.erase(it);
+    }
+}
+
+void ResourceLoader::clearImageCache()
+{
+    imageCache.clear();
+    folderListings.clear();
+    cacheHits = 0;
+    cacheMisses = 0;
+    residentBytes = 0;
+}
+
 bool ResourceLoader::fileExists(const QString& path)
 {
     return QFileInfo::exists(path);
@@ -108,25 +355,24 @@ QStringList ResourceLoader::getFilesInDirectory(const QString& path, const QStri
 }
 
 QString ResourceLoader::getBasePath()
-{
-    return QCoreApplication::applicationDirPath();
-}
-
-QString ResourceLoader::getResourcePath(const QString& relativePath)
 {
     QString appDir = QCoreApplication::applicationDirPath();
     
-    // First, try to find the resource in the application directory (for deployed apps)
-    QString deployedPath = QDir(appDir).absoluteFilePath(relativePath);
-    if (QFileInfo::exists(deployedPath)) {
-        return deployedPath;
+    // Environment override
+    QString envRoot = qEnvironmentVariable("SPROUTS_ASSET_ROOT");
+    if (!envRoot.isEmpty()) {
+        return QDir(envRoot).absolutePath();
     }
     
-    // If not found in app directory, try development environment paths
-    QDir dir(appDir);
+    // Deployed apps ship their assets next to the executable
+    QDir appDirectory(appDir);
+    if (appDirectory.exists("graphics") && appDirectory.exists("data")) {
+        return appDirectory.absolutePath();
+    }
     
-    // Navigate up from build directory to source directory
+    // Development environment: navigate up from the build directory to the source directory
     // Typical structure: source/build/Desktop_Qt_6_5_3_MinGW_64_bit-Debug/debug/
+    QDir dir(appDir);
     while (dir.dirName().contains("build") || dir.dirName().contains("debug") || 
            dir.dirName().contains("release") || dir.dirName().contains("Desktop")) {
         if (!dir.cdUp()) break;
@@ -141,12 +387,39 @@ QString ResourceLoader::getResourcePath(const QString& relativePath)
         }
     }
     
-    QString sourcePath = dir.absoluteFilePath(relativePath);
+    if (dir.exists("graphics")) {
+        return dir.absolutePath();
+    }
     
-    // If source path exists, return it; otherwise return the deployed path anyway
-    if (QFileInfo::exists(sourcePath)) {
-        return sourcePath;
+    // Nothing found; fall back to the application directory
+    return appDirectory.absolutePath();
+}
+
+QString ResourceLoader::assetRoot()
+{
+    if (resolvedRoot.isEmpty()) {
+        resolvedRoot = getBasePath();
+        qDebug() << "ResourceLoader: Asset root is" << resolvedRoot;
+    }
+    return resolvedRoot;
+}
+
+void ResourceLoader::setAssetRoot(const QString& path)
+{
+    resolvedRoot = QDir(path).absolutePath();
+    resolvedPaths.clear();
+    qDebug() << "ResourceLoader: Asset root set to" << resolvedRoot;
+}
+
+QString ResourceLoader::getResourcePath(const QString& relativePath)
+{
+    auto it = resolvedPaths.constFind(relativePath);
+    if (it != resolvedPaths.constEnd()) {
+        return it.value();
     }
     
-    return deployedPath;
+    // Pure string work: the root was probed once, individual files are not
+    QString absolutePath = QDir::cleanPath(QDir(assetRoot()).absoluteFilePath(relativePath));
+    resolvedPaths.insert(relativePath, absolutePath);
+    return absolutePath;
 }
\ No newline at end of file
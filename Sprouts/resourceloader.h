@@ -5,8 +5,15 @@
 #include <QPixmap>
 #include <QVector>
 #include <QMap>
+#include <QHash>
 #include <QString>
 #include <QDir>
+#include <QImage>
+
+class AssetPack;
+
+// Default budget for decoded images kept by the cache
+const qint64 DEFAULT_IMAGE_BUDGET = 256ll * 1024 * 1024;
 
 class ResourceLoader : public QObject
 {
@@ -24,6 +31,45 @@ public:
     // Load single image
     static QPixmap loadImage(const QString& path);
     
+    // Decoded image cache statistics
+    static int imageCacheHits() { return cacheHits; }
+    static int imageCacheMisses() { return cacheMisses; }
+    static void clearImageCache();
+    
+    // Residency: images are tracked by the frame they were last requested in and
+    // evicted least-recently-used first once the budget is exceeded. Images still
+    // referenced elsewhere (e.g. by a sprite) or used this frame are never evicted.
+    static void beginFrame();
+    static void setImageBudget(qint64 bytes) { imageBudget = bytes; }
+    static qint64 imageBudgetBytes() { return imageBudget; }
+    static qint64 imageMemory() { return residentBytes; }
+    static qint64 peakImageMemory() { return peakResidentBytes; }
+    static void reportImageMemory();
+    
+    // Drop cached data for files that changed on disk (hot reload)
+    static void invalidateImage(const QString& absolutePath);
+    static void invalidateFolderListings() { folderListings.clear(); }
+    
+    // Seed the cache with an image decoded elsewhere (see AssetPreloader)
+    static void insertImage(const QString& absolutePath, const QPixmap& pixmap);
+    
+    // Decode an image from the asset pack or disk; safe to call from worker threads
+    static QImage decodeImage(const QString& absolutePath);
+    
+    // Image files in a folder (absolute paths, sorted by name)
+    static QStringList imageFiles(const QString& path, bool recursive = false);
+    
+    // Raw file contents from the asset pack or disk
+    static QByteArray readFile(const QString& relativePath);
+    
+    // Modification time and size of an asset, used to validate derived caches
+    static bool fileStamp(const QString& relativePath, qint64& modified, qint64& size);
+    
+    // Asset pack; when open, assets it contains are read from it instead of loose files
+    static bool openPack(const QString& packPath);
+    static void closePack();
+    static bool hasPack() { return pack != nullptr; }
+    
     // Check if file exists
     static bool fileExists(const QString& path);
     
@@ -32,9 +78,46 @@ public:
     
 public:
     static QString getResourcePath(const QString& relativePath);
+    
+    // Asset root, resolved once per process. An explicit root (--assets) wins over
+    // SPROUTS_ASSET_ROOT, which wins over probing the application/source directories.
+    static QString assetRoot();
+    static void setAssetRoot(const QString& path);
 
 private:
     static QString getBasePath();
+    
+    static QString resolvedRoot;
+    static QHash<QString, QString> resolvedPaths;
+    
+    static AssetPack* pack;
+    static QString packPath(const QString& absolutePath);
+    
+    // Decode an image once per resolved path; later requests share the same pixmap data
+    static QPixmap cachedPixmap(const QString& absolutePath);
+    
+    struct CachedImage {
+        QPixmap pixmap;
+        qint64 bytes = 0;
+        quint64 lastUsedFrame = 0;
+    };
+    
+    static QHash<QString, CachedImage> imageCache;
+    static QHash<QString, QStringList> folderListings;
+    static int cacheHits;
+    static int cacheMisses;
+    
+    static quint64 currentFrame;
+    static qint64 imageBudget;
+    static qint64 residentBytes;
+    static qint64 peakResidentBytes;
+    static double residentBytesSum;
+    static quint64 sampledFrames;
+    static int evictions;
+    
+    static void insertResident(const QString& absolutePath, const QPixmap& pixmap, quint64 frame);
+    static void enforceBudget();
+    static QStringList listFolder(const QString& path, bool recursive);
 };
 
 #endif // RESOURCELOADER_H
\ No newline at end of file
@@ -70,55 +70,18 @@ void Sky::reset()
     endColor = QColor(38, 101, 189);
 }
 
-// Drop implementation
-Drop::Drop(const QPointF& pos, const QPixmap& surf, bool moving, SpriteGroup* group)
-    : Generic(pos.toPoint(), surf, QVector<SpriteGroup*>{group}, RAIN), moving(moving)
-{
-    // Random lifetime for drops
-    lifetime = QRandomGenerator::global()->bounded(400, 500);
-    startTime = 0;
-    
-    if (moving) {
-        direction = QPointF(QRandomGenerator::global()->bounded(-2, 3), 
-                           QRandomGenerator::global()->bounded(4, 7));
-        speed = QRandomGenerator::global()->bounded(200, 250);
-    }
-}
-
-void Drop::update(float dt)
-{
-    if (moving) {
-        // Move the drop
-        QPointF movement = direction * speed * dt;
-        rect.translate(movement.toPoint());
-        hitbox.translate(movement.toPoint());
-        
-        // Remove if off screen (use map height instead of screen height)
-        const int MAP_HEIGHT = 40 * 64; // 40 tiles * 64 pixels per tile = 2560
-        if (rect.y() > MAP_HEIGHT) {
-            kill();
-        }
-    } else {
-        // Ground drop - fade out over time
-        startTime += dt * 1000; // Convert to milliseconds
-        if (startTime > lifetime) {
-            kill();
-        }
-    }
-}
-
 // Rain implementation
-Rain::Rain(SpriteGroup* allSprites, QObject *parent)
-    : QObject{parent}, allSprites(allSprites), rainTimer(0.0f), floorTimer(0.0f)
+Rain::Rain(QObject *parent)
+    : QObject{parent}, rainTimer(0.0f), floorTimer(0.0f)
 {
     // Load rain graphics
-    rainDrops.append(QPixmap(ResourceLoader::getResourcePath("graphics/rain/drops/0.png")));
-    rainDrops.append(QPixmap(ResourceLoader::getResourcePath("graphics/rain/drops/1.png")));
-    rainDrops.append(QPixmap(ResourceLoader::getResourcePath("graphics/rain/drops/2.png")));
+    rainDrops.append(ResourceLoader::loadImage("graphics/rain/drops/0.png"));
+    rainDrops.append(ResourceLoader::loadImage("graphics/rain/drops/1.png"));
+    rainDrops.append(ResourceLoader::loadImage("graphics/rain/drops/2.png"));
     
-    rainFloor.append(QPixmap(ResourceLoader::getResourcePath("graphics/rain/floor/0.png")));
-    rainFloor.append(QPixmap(ResourceLoader::getResourcePath("graphics/rain/floor/1.png")));
-    rainFloor.append(QPixmap(ResourceLoader::getResourcePath("graphics/rain/floor/2.png")));
+    rainFloor.append(ResourceLoader::loadImage("graphics/rain/floor/0.png"));
+    rainFloor.append(ResourceLoader::loadImage("graphics/rain/floor/1.png"));
+    rainFloor.append(ResourceLoader::loadImage("graphics/rain/floor/2.png"));
     
     // Remove null pixmaps (filter out empty pixmaps)
     for (int i = rainDrops.size() - 1; i >= 0; --i) {
@@ -133,68 +96,149 @@ Rain::Rain(SpriteGroup* allSprites, QObject *parent)
     }
 }
 
-void Rain::createRainDrops()
+void Rain::DropBuffer::append(float px, float py, float dx, float dy, float life, int image)
+{
+    x.append(px);
+    y.append(py);
+    vx.append(dx);
+    vy.append(dy);
+    age.append(0.0f);
+    lifetime.append(life);
+    frame.append(image);
+}
+
+void Rain::DropBuffer::step(float dt, const QRectF& bounds)
+{
+    const int count = size();
+    float* px = x.data();
+    float* py = y.data();
+    float* dx = vx.data();
+    float* dy = vy.data();
+    float* a = age.data();
+    float* life = lifetime.data();
+    int* image = frame.data();
+    
+    // Integrate; no branches so the compiler can vectorize it
+    for (int i = 0; i < count; ++i) {
+        px[i] += dx[i] * dt;
+        py[i] += dy[i] * dt;
+        a[i] += dt;
+    }
+    
+    // Compact out drops that expired or that the camera left behind
+    const float left = bounds.left();
+    const float top = bounds.top();
+    const float right = bounds.right();
+    const float bottom = bounds.bottom();
+    int kept = 0;
+    for (int i = 0; i < count; ++i) {
+        if (a[i] >= life[i] || px[i] < left || px[i] > right || py[i] < top || py[i] > bottom) {
+            continue;
+        }
+        px[kept] = px[i];
+        py[kept] = py[i];
+        dx[kept] = dx[i];
+        dy[kept] = dy[i];
+        a[kept] = a[i];
+        life[kept] = life[i];
+        image[kept] = image[i];
+        kept++;
+    }
+    x.resize(kept);
+    y.resize(kept);
+    vx.resize(kept);
+    vy.resize(kept);
+    age.resize(kept);
+    lifetime.resize(kept);
+    frame.resize(kept);
+}
+
+void Rain::createRainDrops(const QRectF& bounds)
 {
     if (rainDrops.isEmpty()) return;
     
-    // Map dimensions: 50x40 tiles, each tile is 64 pixels
-    const int MAP_WIDTH = 50 * TILE_SIZE;  // 3200 pixels
-    const int MAP_HEIGHT = 40 * TILE_SIZE; // 2560 pixels
+    QRandomGenerator* random = QRandomGenerator::global();
     
     // Create falling rain drops
     for (int i = 0; i < 10; ++i) {
-        int x = QRandomGenerator::global()->bounded(MAP_WIDTH);
-        int y = QRandomGenerator::global()->bounded(-50, -10);
+        float x = bounds.left() + random->bounded(bounds.width());
+        float y = bounds.top() + random->bounded(bounds.height());
         
-        int surfIndex = QRandomGenerator::global()->bounded(rainDrops.size());
-        QPixmap surf = rainDrops[surfIndex];
+        float speed = random->bounded(200, 250);
+        float dx = random->bounded(-2, 3) * speed;
+        float dy = random->bounded(4, 7) * speed;
+        float lifetime = random->bounded(400, 500) / 1000.0f;
         
-        QVector<SpriteGroup*> groups;
-        groups.append(allSprites);
-        
-        Drop* drop = new Drop(QPointF(x, y), surf, true, allSprites);
-        drop->setParent(this);
+        falling.append(x, y, dx, dy, lifetime, random->bounded(rainDrops.size()));
     }
 }
 
-void Rain::createFloorDrops()
+void Rain::createFloorDrops(const QRectF& bounds)
 {
     if (rainFloor.isEmpty()) return;
     
-    // Map dimensions: 50x40 tiles, each tile is 64 pixels
-    const int MAP_WIDTH = 50 * TILE_SIZE;  // 3200 pixels
-    const int MAP_HEIGHT = 40 * TILE_SIZE; // 2560 pixels
+    QRandomGenerator* random = QRandomGenerator::global();
     
     // Create ground rain effects
     for (int i = 0; i < 3; ++i) {
-        int x = QRandomGenerator::global()->bounded(MAP_WIDTH);
-        int y = QRandomGenerator::global()->bounded(MAP_HEIGHT);
-        
-        int surfIndex = QRandomGenerator::global()->bounded(rainFloor.size());
-        QPixmap surf = rainFloor[surfIndex];
+        float x = bounds.left() + random->bounded(bounds.width());
+        float y = bounds.top() + random->bounded(bounds.height());
+        float lifetime = random->bounded(400, 500) / 1000.0f;
         
-        QVector<SpriteGroup*> groups;
-        groups.append(allSprites);
-        
-        Drop* drop = new Drop(QPointF(x, y), surf, false, allSprites);
-        drop->setParent(this);
+        floor.append(x, y, 0.0f, 0.0f, lifetime, random->bounded(rainFloor.size()));
     }
 }
 
-void Rain::update(float dt)
+void Rain::update(float dt, const QRectF& view)
 {
+    // Drops are kept in the view plus a margin so the edges fill in smoothly
+    QRectF bounds(view.left() - RAIN_MARGIN, view.top() - RAIN_MARGIN,
+                  view.width() + 2 * RAIN_MARGIN, view.height() + 2 * RAIN_MARGIN);
+    
+    falling.step(dt, bounds);
+    floor.step(dt, bounds);
+    
     rainTimer += dt;
     floorTimer += dt;
     
     // Create rain drops more frequently (every 0.05 seconds)
     if (rainTimer >= 0.05f) {
-        createRainDrops();
+        createRainDrops(bounds);
         rainTimer = 0;
     }
     
     // Create floor drops more frequently (every 0.1 seconds)
     if (floorTimer >= 0.1f) {
-        createFloorDrops();
+        createFloorDrops(bounds);
         floorTimer = 0;
     }
+}
+
+void Rain::display(QPainter& painter, const QPointF& offset)
+{
+    drawBuffer(painter, floor, rainFloor, offset);
+    drawBuffer(painter, falling, rainDrops, offset);
+}
+
+void Rain::drawBuffer(QPainter& painter, const DropBuffer& buffer,
+                      const QVector<QPixmap>& images, const QPointF& offset)
+{
+    // One drawPixmapFragments call per image; fragments are positioned by their centre
+    for (int image = 0; image < images.size(); ++image) {
+        const QPixmap& pixmap = images[image];
+        QRectF source(0, 0, pixmap.width(), pixmap.height());
+        QPointF half(pixmap.width() / 2.0, pixmap.height() / 2.0);
+        
+        fragments.clear();
+        for (int i = 0; i < buffer.size(); ++i) {
+            if (buffer.frame[i] == image) {
+                QPointF topLeft(buffer.x[i] - offset.x(), buffer.y[i] - offset.y());
+                fragments.append(QPainter::PixmapFragment::create(topLeft + half, source));
+            }
+        }
+        
+        if (!fragments.isEmpty()) {
+            painter.drawPixmapFragments(fragments.constData(), fragments.size(), pixmap);
+        }
+    }
 }
\ No newline at end of file
@@ -7,6 +7,7 @@
 #include <QVector>
 #include <QPixmap>
 #include <QPointF>
+#include <QRectF>
 #include "sprite.h"
 #include "gamesettings.h"
 
@@ -31,43 +32,50 @@ private:
     void updateColor(float currentTime);
 };
 
-class Drop : public Generic
+// Rain drawn as a screen-space effect. Drops only exist in the area around
+// the camera and are not sprites: they live in flat arrays so the update is a
+// plain loop, and are drawn after the sprites with one batched call per image.
+class Rain : public QObject
 {
     Q_OBJECT
 
 public:
-    Drop(const QPointF& pos, const QPixmap& surf, bool moving, SpriteGroup* group);
+    explicit Rain(QObject *parent = nullptr);
+    
+    // Spawn and move drops around the visible part of the world
+    void update(float dt, const QRectF& view);
     
-    void update(float dt) override;
+    // Draw the drops; offset is the camera offset
+    void display(QPainter& painter, const QPointF& offset);
     
 private:
-    int lifetime;
-    qint64 startTime;
-    bool moving;
-    QPointF direction;
-    float speed;
-};
-
-class Rain : public QObject
-{
-    Q_OBJECT
-
-public:
-    explicit Rain(SpriteGroup* allSprites, QObject *parent = nullptr);
+    // Structure of arrays, one entry per drop, in world coordinates
+    struct DropBuffer {
+        QVector<float> x;
+        QVector<float> y;
+        QVector<float> vx;
+        QVector<float> vy;
+        QVector<float> age;
+        QVector<float> lifetime;
+        QVector<int> frame;
+        
+        int size() const { return x.size(); }
+        void append(float px, float py, float dx, float dy, float life, int image);
+        void step(float dt, const QRectF& bounds);
+    };
     
-    // Update rain
-    void update(float dt);
+    void drawBuffer(QPainter& painter, const DropBuffer& buffer,
+                    const QVector<QPixmap>& images, const QPointF& offset);
     
-private:
-    SpriteGroup* allSprites;
     QVector<QPixmap> rainDrops;
     QVector<QPixmap> rainFloor;
-    int floorWidth;
-    int floorHeight;
+    DropBuffer falling;
+    DropBuffer floor;
+    QVector<QPainter::PixmapFragment> fragments;
     
     // Create rain effects
-    void createFloorDrops();
-    void createRainDrops();
+    void createFloorDrops(const QRectF& bounds);
+    void createRainDrops(const QRectF& bounds);
     
     // Timers
     float rainTimer;
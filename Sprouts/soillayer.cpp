@@ -3,20 +3,20 @@
 #include "sprite.h"
 #include "plant.h"
 #include "resourceloader.h"
+#include "startupprofiler.h"
+#include "tmxmap.h"
 #include <QDebug>
-#include <QFile>
-#include <QXmlStreamReader>
 #include <QStringList>
-#include <QCoreApplication>
-#include <QDir>
 #include <QUrl>
 
-SoilLayer::SoilLayer(SpriteGroup* allSprites, SpriteGroup* collisionSprites, QObject *parent)
-    : QObject{parent}, raining(false), allSprites(allSprites), collisionSprites(collisionSprites)
+SoilLayer::SoilLayer(SpriteGroup* allSprites, SpriteGroup* collisionSprites, const TmxMap& map,
+                     EntityRegistry* entities, QObject *parent)
+    : QObject{parent}, raining(false), allSprites(allSprites), collisionSprites(collisionSprites),
+      entities(entities)
 {
-    // Initialize grid
-    gridWidth = 50; // Map width in tiles
-    gridHeight = 40; // Map height in tiles
+    // Initialize grid to the map size in tiles
+    gridWidth = map.width;
+    gridHeight = map.height;
     
     grid.resize(gridHeight);
     for (int y = 0; y < gridHeight; ++y) {
@@ -24,7 +24,7 @@ SoilLayer::SoilLayer(SpriteGroup* allSprites, SpriteGroup* collisionSprites, QOb
     }
     
     // Initialize plant sprites group
-    plantSprites = new SpriteGroup(this);
+    plantSprites = new TypedGroup<Plant>(this);
     
     // Initialize soil sprites group
     soilSprites = new SpriteGroup(this);
@@ -39,11 +39,20 @@ SoilLayer::SoilLayer(SpriteGroup* allSprites, SpriteGroup* collisionSprites, QOb
     setupAudio();
     
     // Initialize farmable grid
-    createSoilGrid();
+    createSoilGrid(map);
+}
+
+void SoilLayer::reloadGraphics()
+{
+    loadSoilGraphics();
+    createSoilTiles();
+    createWaterTiles();
 }
 
 void SoilLayer::loadSoilGraphics()
 {
+    StartupProfiler::Scope scope("SoilLayer::loadSoilGraphics");
+
     // Load soil surfaces
     QStringList soilTypes = {"b", "bl", "bm", "br", "l", "lm", "lr", "lrb", "lrt", 
                             "o", "r", "rm", "soil", "t", "tb", "tbl", "tbr", 
@@ -126,17 +135,17 @@ bool SoilLayer::plantSeed(const QPointF& point, const QString& seed)
         QPointF worldPos = gridToWorld(gridPos);
         
         // Find the soil sprite at this position for reference
-        Sprite* soilSprite = nullptr;
+        SpriteHandle soilSprite;
         for (Sprite* sprite : soilSprites->sprites()) {
             if (sprite->rect.contains(worldPos.toPoint())) {
-                soilSprite = sprite;
+                soilSprite = sprite->handle();
                 break;
             }
         }
         
         // Create plant with growth logic
-        Plant* plant = new Plant(seed, plantGroups, soilSprite, 
-                                [this](const QPointF& pos) { return checkWatered(pos); }, this);
+        entities->adopt(new Plant(seed, plantGroups, soilSprite, entities,
+                                  [this](const QPointF& pos) { return checkWatered(pos); }));
         
         qDebug() << "SoilLayer: Plant created at" << worldPos << "for seed" << seed;
         return true; // Successfully planted
@@ -193,8 +202,7 @@ void SoilLayer::createSoilTiles()
                     soilGroups.append(allSprites);
                     soilGroups.append(soilSprites);
                     
-                    Generic* soil = new Generic(worldPos.toPoint(), soilSurf, soilGroups, SOIL);
-                    soil->setParent(this);
+                    entities->adopt(new Generic(worldPos.toPoint(), soilSurf, soilGroups, SOIL));
                 }
             }
         }
@@ -219,12 +227,18 @@ void SoilLayer::createWaterTiles()
                     waterGroups.append(allSprites);
                     waterGroups.append(waterSprites);
                     
-                    Generic* water = new Generic(worldPos.toPoint(), waterSurf, waterGroups, SOIL_WATER);
-                    water->setParent(this);
+                    entities->adopt(new Generic(worldPos.toPoint(), waterSurf, waterGroups, SOIL_WATER));
                 }
             }
         }
     }
+    
+    // Watering is what lets dry plants grow again
+    for (Plant* plant : *plantSprites) {
+        if (!plant->harvestable) {
+            plant->setTicking(true);
+        }
+    }
 }
 
 void SoilLayer::updatePlants()
@@ -277,86 +291,31 @@ bool SoilLayer::isValidGridPos(const QPoint& gridPos)
            gridPos.y() >= 0 && gridPos.y() < gridHeight;
 }
 
-void SoilLayer::createSoilGrid()
+void SoilLayer::createSoilGrid(const TmxMap& map)
 {
-    // Parse TMX file to get Farmable layer data
-    QString tmxFilePath = "data/map.tmx";
-    QFile file(tmxFilePath);
-    
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        qDebug() << "Failed to open TMX file for farmable data:" << tmxFilePath;
-        // Try alternative paths
-        QStringList alternativePaths = {
-            QCoreApplication::applicationDirPath() + "/data/map.tmx",
-            QCoreApplication::applicationDirPath() + "/../data/map.tmx",
-            QCoreApplication::applicationDirPath() + "/../../data/map.tmx",
-            QCoreApplication::applicationDirPath() + "/../../../data/map.tmx"
-        };
-        
-        bool found = false;
-        for (const QString& altPath : alternativePaths) {
-            QFile altFile(altPath);
-            if (altFile.exists()) {
-                tmxFilePath = altPath;
-                file.setFileName(tmxFilePath);
-                if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-                    found = true;
-                    break;
-                }
-            }
-        }
-        
-        if (!found) {
-            qDebug() << "Could not find TMX file, using fallback farmable area";
-            // Fallback to hardcoded area
-            for (int y = 15; y < 25 && y < gridHeight; ++y) {
-                for (int x = 15; x < 35 && x < gridWidth; ++x) {
-                    grid[y][x].append("F");
-                }
+    // Read the precomputed farmable bits from the shared map model
+    if (!map.hasFarmableLayer) {
+        qDebug() << "SoilLayer: Map has no Farmable layer, using fallback farmable area";
+        // Fallback to hardcoded area
+        for (int y = 15; y < 25 && y < gridHeight; ++y) {
+            for (int x = 15; x < 35 && x < gridWidth; ++x) {
+                grid[y][x].append("F");
             }
-            return;
         }
+        return;
     }
     
-    QXmlStreamReader xml(&file);
     int farmableCount = 0;
     
-    while (!xml.atEnd() && !xml.hasError()) {
-        QXmlStreamReader::TokenType token = xml.readNext();
-        
-        if (token == QXmlStreamReader::StartElement) {
-            if (xml.name() == QLatin1String("layer")) {
-                QXmlStreamAttributes attributes = xml.attributes();
-                QString layerName = attributes.value("name").toString();
-                
-                if (layerName == "Farmable") {
-                    // Find the data element for this layer
-                    while (!xml.atEnd() && !(xml.isStartElement() && xml.name() == QLatin1String("data"))) {
-                        xml.readNext();
-                    }
-                    
-                    if (xml.isStartElement() && xml.name() == QLatin1String("data")) {
-                        QString csvData = xml.readElementText().trimmed();
-                        QStringList lines = csvData.split('\n', Qt::SkipEmptyParts);
-                        
-                        for (int y = 0; y < lines.size() && y < gridHeight; ++y) {
-                            QStringList values = lines[y].split(',', Qt::SkipEmptyParts);
-                            for (int x = 0; x < values.size() && x < gridWidth; ++x) {
-                                int tileId = values[x].trimmed().toInt();
-                                if (tileId == 169) { // Farmable tile ID
-                                    grid[y][x].append("F");
-                                    farmableCount++;
-                                }
-                            }
-                        }
-                    }
-                    break; // Found Farmable layer, no need to continue
-                }
+    for (int y = 0; y < map.height && y < gridHeight; ++y) {
+        for (int x = 0; x < map.width && x < gridWidth; ++x) {
+            if (map.isFarmable(x, y)) {
+                grid[y][x].append("F");
+                farmableCount++;
             }
         }
     }
     
-    file.close();
     qDebug() << "SoilLayer: Created farmable grid with" << farmableCount << "farmable tiles from TMX data";
 }
 
@@ -8,17 +8,20 @@
 #include <QMap>
 #include <QSoundEffect>
 #include "gamesettings.h"
+#include "entityregistry.h"
+#include "spritegroup.h"
 
-class SpriteGroup;
 class Sprite;
 class Plant;
+class TmxMap;
 
 class SoilLayer : public QObject
 {
     Q_OBJECT
 
 public:
-    explicit SoilLayer(SpriteGroup* allSprites, SpriteGroup* collisionSprites, QObject *parent = nullptr);
+    explicit SoilLayer(SpriteGroup* allSprites, SpriteGroup* collisionSprites, const TmxMap& map,
+                       EntityRegistry* entities, QObject *parent = nullptr);
     
     // Soil actions
     void getHit(const QPointF& point);
@@ -31,9 +34,12 @@ public:
     void waterAll();
     bool checkWatered(const QPointF& worldPos);
     
+    // Reload soil and water graphics and rebuild their tiles (hot reload)
+    void reloadGraphics();
+    
     // Properties
     bool raining;
-    SpriteGroup* plantSprites;
+    TypedGroup<Plant>* plantSprites;
     
     // Grid system (public for plant harvesting)
     QVector<QVector<QVector<QString>>> grid; // 2D grid with list of states per cell
@@ -51,6 +57,9 @@ private:
     SpriteGroup* soilSprites;
     SpriteGroup* waterSprites;
     
+    // Owns the soil, water and plant sprites (the level's registry)
+    EntityRegistry* entities;
+    
     // Graphics
     QMap<QString, QPixmap> soilSurfs;
     QMap<QString, QPixmap> waterSurfs;
@@ -63,7 +72,7 @@ private:
     void createSoilTiles();
     void createWaterTiles();
     void loadSoilGraphics();
-    void createSoilGrid();
+    void createSoilGrid(const TmxMap& map);
     void setupAudio();
 };
 
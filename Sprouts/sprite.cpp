@@ -1,22 +1,21 @@
 #include "sprite.h"
 #include "spritegroup.h"
 #include <QDebug>
-#include <QDateTime>
-#include <QElapsedTimer>
 
 // Sprite implementation
-Sprite::Sprite(QObject *parent)
-    : QObject{parent}, z(MAIN), alive(true)
+Sprite::Sprite()
+    : z(MAIN), alive(true)
 {
 }
 
 Sprite::~Sprite()
 {
     // Remove from all groups
-    for (SpriteGroup* group : groups) {
-        if (group) {
-            group->removeSprite(this);
+    for (int i = 0; i < groups.size(); ++i) {
+        if (activeSlots[i] >= 0) {
+            groups[i]->removeActiveSlot(activeSlots[i]);
         }
+        groups[i]->removeSlot(groupSlots[i]);
     }
 }
 
@@ -24,25 +23,77 @@ void Sprite::addToGroup(SpriteGroup* group)
 {
     if (group && !groups.contains(group)) {
         groups.append(group);
-        group->addSprite(this);
+        groupSlots.append(group->insertSprite(this));
+        activeSlots.append(ticking ? group->insertActive(this) : -1);
     }
 }
 
 void Sprite::removeFromGroup(SpriteGroup* group)
 {
-    if (group && groups.contains(group)) {
-        groups.removeOne(group);
-        group->removeSprite(this);
+    int index = groups.indexOf(group);
+    if (index < 0) {
+        return;
+    }
+    
+    int slot = groupSlots[index];
+    int activeSlot = activeSlots[index];
+    groups.removeAt(index);
+    groupSlots.removeAt(index);
+    activeSlots.removeAt(index);
+    if (activeSlot >= 0) {
+        group->removeActiveSlot(activeSlot);
+    }
+    group->removeSlot(slot);
+}
+
+void Sprite::setTicking(bool on)
+{
+    if (ticking == on) {
+        return;
+    }
+    ticking = on;
+    previousPos = rect.topLeft();
+    
+    for (int i = 0; i < groups.size(); ++i) {
+        if (on) {
+            activeSlots[i] = groups[i]->insertActive(this);
+        } else {
+            groups[i]->removeActiveSlot(activeSlots[i]);
+            activeSlots[i] = -1;
+        }
+    }
+}
+
+QPointF Sprite::renderPos(float alpha) const
+{
+    // Dormant sprites did not move during the step
+    if (!ticking) {
+        return rect.topLeft();
     }
+    return QPointF(previousPos) + QPointF(rect.topLeft() - previousPos) * alpha;
+}
+
+void Sprite::setGroupSlot(SpriteGroup* group, int slot)
+{
+    groupSlots[groups.indexOf(group)] = slot;
+}
+
+void Sprite::setActiveSlot(SpriteGroup* group, int slot)
+{
+    activeSlots[groups.indexOf(group)] = slot;
 }
 
 void Sprite::kill()
 {
     alive = false;
-    // Remove from all groups
-    QVector<SpriteGroup*> groupsCopy = groups; // Copy to avoid modification during iteration
-    for (SpriteGroup* group : groupsCopy) {
-        removeFromGroup(group);
+    // Remove from all groups, last first
+    while (!groups.isEmpty()) {
+        removeFromGroup(groups.last());
+    }
+    
+    // Registered sprites are freed at the end of the frame
+    if (registry) {
+        registry->destroyLater(registryHandle);
     }
 }
 
@@ -50,6 +101,18 @@ void Sprite::kill()
 Generic::Generic(const QPoint& pos, const QPixmap& surf, QVector<SpriteGroup*> groups, Layer layer)
     : Sprite()
 {
+    respawn(pos, surf, groups, layer);
+}
+
+Generic::Generic()
+    : Sprite()
+{
+    alive = false;
+}
+
+void Generic::respawn(const QPoint& pos, const QPixmap& surf, const QVector<SpriteGroup*>& groups, Layer layer)
+{
+    alive = true;
     image = surf;
     rect = QRect(pos, surf.size());
     z = layer;
@@ -81,6 +144,7 @@ Interaction::Interaction(const QPoint& pos, const QSize& size, QVector<SpriteGro
 Water::Water(const QPoint& pos, const QVector<QPixmap>& frames, QVector<SpriteGroup*> groups)
     : Generic(pos, frames.isEmpty() ? QPixmap() : frames[0], groups, WATER), frames(frames), frameIndex(0)
 {
+    setTicking(!frames.isEmpty());
 }
 
 void Water::animate(float dt)
@@ -109,25 +173,4 @@ WildFlower::WildFlower(const QPoint& pos, const QPixmap& surf, QVector<SpriteGro
     hitbox = QRect(rect.x() + 10,
                    rect.y() + rect.height() - hitboxHeight,
                    hitboxWidth, hitboxHeight);
-}
-
-// Particle implementation
-Particle::Particle(const QPoint& pos, const QPixmap& surf, QVector<SpriteGroup*> groups, Layer layer, int duration)
-    : Generic(pos, surf, groups, layer), duration(duration)
-{
-    startTime = QDateTime::currentMSecsSinceEpoch();
-    
-    // Create white surface effect
-    QPixmap maskedSurf = surf;
-    // Apply white color effect (simplified)
-    // In a full implementation, you might want to use QPainter to create a mask effect
-    image = maskedSurf;
-}
-
-void Particle::update(float /*dt*/)
-{
-    qint64 currentTime = QDateTime::currentMSecsSinceEpoch();
-    if (currentTime - startTime > duration) {
-        kill();
-    }
 }
\ No newline at end of file
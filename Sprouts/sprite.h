@@ -1,22 +1,24 @@
 #ifndef SPRITE_H
 #define SPRITE_H
 
-#include <QObject>
 #include <QPixmap>
 #include <QRect>
 #include <QRectF>
+#include <QPointF>
+#include <QString>
 #include <QVector>
-#include <QTimer>
 #include "gamesettings.h"
+#include "entityregistry.h"
 
 class SpriteGroup;
 
-class Sprite : public QObject
+// World entity base. Deliberately not a QObject: ownership goes through an
+// EntityRegistry or a SpritePool, and only classes that need signals (Player)
+// add QObject.
+class Sprite
 {
-    Q_OBJECT
-
 public:
-    explicit Sprite(QObject *parent = nullptr);
+    Sprite();
     virtual ~Sprite();
 
     // Core properties
@@ -25,32 +27,61 @@ public:
     QRect hitbox;
     Layer z;
     bool alive;
+    
+    // Position before the last simulation step; drawing blends from it to rect
+    QPoint previousPos;
+    QPointF renderPos(float alpha) const;
 
-    // Groups management
+    // Groups management. A sprite is in a handful of groups at most, so the
+    // scans here are short; each group keeps the sprite's slot for O(1) removal.
     void addToGroup(SpriteGroup* group);
     void removeFromGroup(SpriteGroup* group);
     void kill();
 
+    // Handle in the owning EntityRegistry (null for pooled and unowned sprites)
+    SpriteHandle handle() const { return registryHandle; }
+
+    // Only ticking sprites are visited by SpriteGroup::update. Sprites start
+    // out dormant; those with per-frame work opt in, and may go back to sleep
+    // until an event (damage, watering, ...) wakes them again.
+    void setTicking(bool on);
+    bool isTicking() const { return ticking; }
+
     // Virtual methods
     virtual void update(float /*dt*/) {}
     virtual void animate(float /*dt*/) {}
 
 protected:
     QVector<SpriteGroup*> groups;
+
+private:
+    friend class SpriteGroup;
+    friend class EntityRegistry;
+    
+    EntityRegistry* registry = nullptr;
+    SpriteHandle registryHandle;
+    
+    // groupSlots[i] is this sprite's index in groups[i]->spriteList, and
+    // activeSlots[i] its index in groups[i]->activeList (-1 when not ticking)
+    QVector<int> groupSlots;
+    QVector<int> activeSlots;
+    bool ticking = false;
+    void setGroupSlot(SpriteGroup* group, int slot);
+    void setActiveSlot(SpriteGroup* group, int slot);
 };
 
 class Generic : public Sprite
 {
-    Q_OBJECT
-
 public:
     Generic(const QPoint& pos, const QPixmap& surf, QVector<SpriteGroup*> groups, Layer layer = MAIN);
+    
+    // Pooled sprites (see SpritePool): start out dead, come back through respawn()
+    Generic();
+    void respawn(const QPoint& pos, const QPixmap& surf, const QVector<SpriteGroup*>& groups, Layer layer = MAIN);
 };
 
 class Interaction : public Generic
 {
-    Q_OBJECT
-
 public:
     Interaction(const QPoint& pos, const QSize& size, QVector<SpriteGroup*> groups, const QString& name);
     
@@ -59,8 +90,6 @@ public:
 
 class Water : public Generic
 {
-    Q_OBJECT
-
 public:
     Water(const QPoint& pos, const QVector<QPixmap>& frames, QVector<SpriteGroup*> groups);
     
@@ -74,25 +103,8 @@ private:
 
 class WildFlower : public Generic
 {
-    Q_OBJECT
-
 public:
     WildFlower(const QPoint& pos, const QPixmap& surf, QVector<SpriteGroup*> groups);
 };
 
-class Particle : public Generic
-{
-    Q_OBJECT
-
-public:
-    Particle(const QPoint& pos, const QPixmap& surf, QVector<SpriteGroup*> groups, Layer layer, int duration = 200);
-    
-    void update(float dt) override;
-
-private:
-    QTimer* timer;
-    int duration;
-    qint64 startTime;
-};
-
 #endif // SPRITE_H
\ No newline at end of file
@@ -15,44 +15,63 @@ SpriteGroup::~SpriteGroup()
     clear();
 }
 
-void SpriteGroup::addSprite(Sprite* sprite)
+int SpriteGroup::insertSprite(Sprite* sprite)
 {
-    if (sprite && !spriteList.contains(sprite)) {
-        spriteList.append(sprite);
+    spriteList.append(sprite);
+    return spriteList.size() - 1;
+}
+
+void SpriteGroup::removeSlot(int slot)
+{
+    // Swap and pop: the last sprite takes over the freed slot
+    Sprite* last = spriteList.takeLast();
+    if (slot < spriteList.size()) {
+        spriteList[slot] = last;
+        last->setGroupSlot(this, slot);
     }
 }
 
-void SpriteGroup::removeSprite(Sprite* sprite)
+int SpriteGroup::insertActive(Sprite* sprite)
 {
-    if (sprite) {
-        spriteList.removeOne(sprite);
+    activeList.append(sprite);
+    return activeList.size() - 1;
+}
+
+void SpriteGroup::removeActiveSlot(int slot)
+{
+    Sprite* last = activeList.takeLast();
+    if (slot < activeList.size()) {
+        activeList[slot] = last;
+        last->setActiveSlot(this, slot);
     }
 }
 
 void SpriteGroup::update(float dt)
 {
-    // Update all sprites
-    for (Sprite* sprite : spriteList) {
-        if (sprite && sprite->alive) {
+    // Sprites may kill, wake or put to sleep themselves or others while
+    // updating, so walk a snapshot
+    const QVector<Sprite*> sprites = activeList;
+    for (Sprite* sprite : sprites) {
+        if (sprite->alive && sprite->isTicking()) {
+            sprite->previousPos = sprite->rect.topLeft();
             sprite->update(dt);
         }
     }
-    
-    // Remove dead sprites
-    spriteList.erase(
-        std::remove_if(spriteList.begin(), spriteList.end(),
-                      [](Sprite* sprite) { return !sprite || !sprite->alive; }),
-        spriteList.end());
+}
+
+void SpriteGroup::snapPositions()
+{
+    for (Sprite* sprite : activeList) {
+        sprite->previousPos = sprite->rect.topLeft();
+    }
 }
 
 void SpriteGroup::clear()
 {
-    for (Sprite* sprite : spriteList) {
-        if (sprite) {
-            sprite->kill();
-        }
+    // Each kill pops the sprite from the end of the list
+    while (!spriteList.isEmpty()) {
+        spriteList.last()->kill();
     }
-    spriteList.clear();
 }
 
 // CameraGroup implementation
@@ -61,13 +80,20 @@ CameraGroup::CameraGroup(QObject *parent)
 {
 }
 
-void CameraGroup::customDraw(QPainter& painter, Player* player)
+void CameraGroup::follow(Player* player, float alpha)
 {
     if (!player) {
         qDebug() << "CameraGroup: No player found!";
         return;
     }
     
+    QPointF center = player->renderPos(alpha) + QPointF(player->rect.width() / 2.0, player->rect.height() / 2.0);
+    offset.setX(center.x() - SCREEN_WIDTH / 2.0);
+    offset.setY(center.y() - SCREEN_HEIGHT / 2.0);
+}
+
+void CameraGroup::customDraw(QPainter& painter, float alpha)
+{
     // Debug: Print sprite count
     static int debugCounter = 0;
     if (debugCounter % 60 == 0) { // Print every 60 frames (~1 second)
@@ -75,49 +101,32 @@ void CameraGroup::customDraw(QPainter& painter, Player* player)
     }
     debugCounter++;
     
-    // Calculate camera offset
-    offset.setX(player->rect.center().x() - SCREEN_WIDTH / 2.0);
-    offset.setY(player->rect.center().y() - SCREEN_HEIGHT / 2.0);
-    
-    // Sort sprites by layer and Y position
-    sortSpritesByLayer();
+    // Bucket sprites by layer, then sort each bucket by Y position for depth
+    for (QVector<Sprite*>& bucket : layerSprites) {
+        bucket.clear();
+    }
+    for (Sprite* sprite : spriteList) {
+        if (sprite->alive && sprite->z >= 0 && sprite->z <= RAIN_DROPS) {
+            layerSprites[sprite->z].append(sprite);
+        }
+    }
     
     // Draw sprites layer by layer
-    for (int layer = 0; layer <= RAIN_DROPS; ++layer) {
-        // Get sprites for this layer and sort by Y position
-        QVector<Sprite*> layerSprites;
-        for (Sprite* sprite : spriteList) {
-            if (sprite && sprite->alive && sprite->z == layer) {
-                layerSprites.append(sprite);
-            }
-        }
-        
-        // Sort by Y position for depth
-        std::sort(layerSprites.begin(), layerSprites.end(),
+    for (QVector<Sprite*>& bucket : layerSprites) {
+        std::sort(bucket.begin(), bucket.end(),
                  [](Sprite* a, Sprite* b) {
                      return a->rect.center().y() < b->rect.center().y();
                  });
         
         // Draw sprites in this layer
-        for (Sprite* sprite : layerSprites) {
-            QRect offsetRect = sprite->rect;
-            offsetRect.translate(-offset.x(), -offset.y());
+        for (Sprite* sprite : bucket) {
+            QPointF topLeft = sprite->renderPos(alpha) - offset;
+            QRectF offsetRect(topLeft.x(), topLeft.y(), sprite->rect.width(), sprite->rect.height());
             
             // Only draw if sprite is visible on screen
-            if (offsetRect.intersects(QRect(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT))) {
+            if (offsetRect.intersects(QRectF(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT))) {
                 painter.drawPixmap(offsetRect.topLeft(), sprite->image);
             }
         }
     }
-}
-
-void CameraGroup::sortSpritesByLayer()
-{
-    std::sort(spriteList.begin(), spriteList.end(),
-             [](Sprite* a, Sprite* b) {
-                 if (a->z != b->z) {
-                     return a->z < b->z;
-                 }
-                 return a->rect.center().y() < b->rect.center().y();
-             });
 }
\ No newline at end of file
@@ -18,14 +18,17 @@ public:
     explicit SpriteGroup(QObject *parent = nullptr);
     virtual ~SpriteGroup();
 
-    // Sprite management
-    void addSprite(Sprite* sprite);
-    void removeSprite(Sprite* sprite);
+    // Membership is managed through Sprite::addToGroup/removeFromGroup/kill.
+    // Order is not preserved: removal moves the last sprite into the gap.
     QVector<Sprite*> sprites() const { return spriteList; }
     
-    // Update all sprites
+    // Update the ticking sprites; dormant ones are never visited
     virtual void update(float dt);
     
+    // Draw ticking sprites where they are, without blending from their
+    // previous position; for steps in which the group is not updated
+    void snapPositions();
+    
     // Clear all sprites
     void clear();
     
@@ -34,9 +37,23 @@ public:
     
     // Size
     int size() const { return spriteList.size(); }
+    int activeCount() const { return activeList.size(); }
 
 protected:
     QVector<Sprite*> spriteList;
+    // Members that currently tick (see Sprite::setTicking)
+    QVector<Sprite*> activeList;
+
+private:
+    friend class Sprite;
+    
+    // Append a sprite and return its slot; remove the sprite in a slot
+    int insertSprite(Sprite* sprite);
+    void removeSlot(int slot);
+    
+    // Same for the active list
+    int insertActive(Sprite* sprite);
+    void removeActiveSlot(int slot);
 };
 
 class CameraGroup : public SpriteGroup
@@ -46,14 +63,47 @@ class CameraGroup : public SpriteGroup
 public:
     explicit CameraGroup(QObject *parent = nullptr);
     
-    // Custom drawing with camera offset
-    void customDraw(QPainter& painter, Player* player);
+    // Centre the camera on the player as drawn this frame
+    void follow(Player* player, float alpha);
+    
+    // Draw with the camera offset, moving sprites blended between the last
+    // two simulation steps (alpha 0 = previous step, 1 = current)
+    void customDraw(QPainter& painter, float alpha);
     
     // Camera offset
     QPointF offset;
 
 private:
-    void sortSpritesByLayer();
+    // Per-layer draw buckets, refilled every frame
+    QVector<Sprite*> layerSprites[RAIN_DROPS + 1];
+};
+
+// Group whose members are all T, so callers get T* without casting. Sprites
+// join it through the usual addToGroup(), often from a base class constructor
+// before the object is a T, so membership can't be type-checked; only add Ts.
+template<class T>
+class TypedGroup : public SpriteGroup
+{
+public:
+    explicit TypedGroup(QObject *parent = nullptr) : SpriteGroup(parent) {}
+    
+    class const_iterator
+    {
+    public:
+        explicit const_iterator(Sprite* const* it) : it(it) {}
+        T* operator*() const { return static_cast<T*>(*it); }
+        const_iterator& operator++() { ++it; return *this; }
+        bool operator!=(const const_iterator& other) const { return it != other.it; }
+        
+    private:
+        Sprite* const* it;
+    };
+    
+    // Killing the current sprite moves the last one into its place, so loops
+    // that kill must stop (or restart) afterwards
+    const_iterator begin() const { return const_iterator(spriteList.constData()); }
+    const_iterator end() const { return const_iterator(spriteList.constData() + spriteList.size()); }
+    T* at(int index) const { return static_cast<T*>(spriteList.at(index)); }
 };
 
 #endif // SPRITEGROUP_H
\ No newline at end of file
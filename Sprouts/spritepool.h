@@ -0,0 +1,108 @@
+#ifndef SPRITEPOOL_H
+#define SPRITEPOOL_H
+
+#include <QDebug>
+#include <QString>
+#include <QVector>
+#include <utility>
+
+// Recycles short-lived sprites (apples). A sprite is free again once it has
+// been killed; acquire() hands it back out through T::respawn() instead of
+// allocating, so respawning them every morning doesn't grow memory.
+//
+// T must be default constructible (constructing a dead sprite) and provide
+// respawn() taking the same arguments as its constructor.
+template<class T>
+class SpritePool
+{
+public:
+    explicit SpritePool(const QString& name, int capacity = 0)
+        : name(name)
+    {
+        reserve(capacity);
+    }
+
+    ~SpritePool()
+    {
+        clear();
+    }
+
+    SpritePool(const SpritePool&) = delete;
+    SpritePool& operator=(const SpritePool&) = delete;
+
+    // Preallocate dead sprites up to the given capacity
+    void reserve(int capacity)
+    {
+        sprites.reserve(capacity);
+        freeList.reserve(capacity);
+        while (sprites.size() < capacity) {
+            T* sprite = new T();
+            sprites.append(sprite);
+            freeList.append(sprite);
+        }
+    }
+
+    template<class... Args>
+    T* acquire(Args&&... args)
+    {
+        if (freeList.isEmpty()) {
+            collectDead();
+        }
+
+        T* sprite;
+        if (!freeList.isEmpty()) {
+            sprite = freeList.takeLast();
+            sprite->respawn(std::forward<Args>(args)...);
+            reuses++;
+        } else {
+            sprite = new T(std::forward<Args>(args)...);
+            sprites.append(sprite);
+        }
+
+        int live = sprites.size() - freeList.size();
+        if (live > highWater) {
+            highWater = live;
+        }
+        return sprite;
+    }
+
+    // Delete every sprite, live or not
+    void clear()
+    {
+        QVector<T*> owned;
+        owned.swap(sprites);
+        freeList.clear();
+        for (T* sprite : owned) {
+            delete sprite;
+        }
+    }
+
+    int capacity() const { return sprites.size(); }
+    int highWaterMark() const { return highWater; }
+
+    void report() const
+    {
+        qDebug() << "SpritePool" << name << ":" << sprites.size() << "allocated,"
+                 << "high water" << highWater << "live," << reuses << "reuses";
+    }
+
+private:
+    // Killed sprites have already left their groups; rebuild the free list from them
+    void collectDead()
+    {
+        freeList.clear();
+        for (T* sprite : sprites) {
+            if (!sprite->alive) {
+                freeList.append(sprite);
+            }
+        }
+    }
+
+    QString name;
+    QVector<T*> sprites;
+    QVector<T*> freeList;
+    int highWater = 0;
+    qint64 reuses = 0;
+};
+
+#endif // SPRITEPOOL_H
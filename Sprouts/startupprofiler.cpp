@@ -0,0 +1,116 @@
+#include "startupprofiler.h"
+#include <QDebug>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+
+#ifdef QT_DEBUG
+bool StartupProfiler::enabled = true;
+#else
+bool StartupProfiler::enabled = false;
+#endif
+QString StartupProfiler::jsonPath;
+QMutex StartupProfiler::mutex;
+QStringList StartupProfiler::order;
+QHash<QString, StartupProfiler::Phase> StartupProfiler::phases;
+int StartupProfiler::totalFiles = 0;
+qint64 StartupProfiler::totalBytes = 0;
+
+StartupProfiler::Scope::Scope(const QString& phase)
+    : phase(phase), startFiles(0), startBytes(0)
+{
+    if (!enabled) return;
+
+    QMutexLocker locker(&mutex);
+    startFiles = totalFiles;
+    startBytes = totalBytes;
+    timer.start();
+}
+
+StartupProfiler::Scope::~Scope()
+{
+    if (!enabled || !timer.isValid()) return;
+
+    qint64 nsecs = timer.nsecsElapsed();
+    int files;
+    qint64 bytes;
+    {
+        QMutexLocker locker(&mutex);
+        files = totalFiles - startFiles;
+        bytes = totalBytes - startBytes;
+    }
+    record(phase, nsecs, files, bytes);
+}
+
+void StartupProfiler::record(const QString& phase, qint64 nsecs, int files, qint64 bytes)
+{
+    if (!enabled) return;
+
+    QMutexLocker locker(&mutex);
+    if (!phases.contains(phase)) {
+        order.append(phase);
+    }
+    Phase& entry = phases[phase];
+    entry.nsecs += nsecs;
+    entry.calls++;
+    entry.files += files;
+    entry.bytes += bytes;
+}
+
+void StartupProfiler::countFile(qint64 bytes)
+{
+    if (!enabled) return;
+
+    QMutexLocker locker(&mutex);
+    totalFiles++;
+    totalBytes += bytes;
+}
+
+void StartupProfiler::report()
+{
+    if (!enabled) return;
+
+    QMutexLocker locker(&mutex);
+
+    // Phases nest, so times are inclusive and do not add up to a total
+    QStringList lines;
+    lines << QString("%1 %2 %3 %4 %5").arg("Phase", -44).arg("ms", 9).arg("calls", 6).arg("files", 6).arg("bytes", 11);
+    QJsonArray phaseArray;
+
+    for (const QString& name : order) {
+        const Phase& phase = phases[name];
+        double ms = phase.nsecs / 1000000.0;
+        lines << QString("%1 %2 %3 %4 %5").arg(name.left(44), -44).arg(ms, 9, 'f', 2)
+                     .arg(phase.calls, 6).arg(phase.files, 6).arg(phase.bytes, 11);
+
+        QJsonObject object;
+        object["phase"] = name;
+        object["ms"] = ms;
+        object["calls"] = phase.calls;
+        object["files"] = phase.files;
+        object["bytes"] = double(phase.bytes);
+        phaseArray.append(object);
+    }
+    lines << QString("Total read: %1 files, %2 bytes").arg(totalFiles).arg(totalBytes);
+
+    qDebug().noquote() << "Startup report:\n" + lines.join('\n');
+
+    if (!jsonPath.isEmpty()) {
+        QJsonObject root;
+        root["phases"] = phaseArray;
+        root["files"] = totalFiles;
+        root["bytes"] = double(totalBytes);
+
+        QFile file(jsonPath);
+        if (file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            file.write(QJsonDocument(root).toJson());
+        } else {
+            qDebug() << "StartupProfiler: Failed to write" << jsonPath;
+        }
+    }
+
+    // Startup is over; stop paying for the mutex and the phase table during gameplay
+    enabled = false;
+}
\ No newline at end of file
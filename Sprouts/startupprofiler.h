@@ -0,0 +1,62 @@
+#ifndef STARTUPPROFILER_H
+#define STARTUPPROFILER_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+
+// Collects timings for the startup phases along with the number of files and
+// bytes read while each phase was running. Phases with the same name are
+// accumulated. Enabled by default in debug builds, and with --startup-report
+// in release builds.
+class StartupProfiler
+{
+public:
+    // Times the enclosing block as one call of a phase
+    class Scope
+    {
+    public:
+        explicit Scope(const QString& phase);
+        ~Scope();
+
+    private:
+        QString phase;
+        QElapsedTimer timer;
+        int startFiles;
+        qint64 startBytes;
+    };
+
+    static bool isEnabled() { return enabled; }
+    static void setEnabled(bool on) { enabled = on; }
+    static void setJsonPath(const QString& path) { jsonPath = path; }
+
+    // Add a finished phase measured elsewhere
+    static void record(const QString& phase, qint64 nsecs, int files = 0, qint64 bytes = 0);
+
+    // Count a file read; safe to call from worker threads
+    static void countFile(qint64 bytes);
+
+    // Print the phase table, and write it as JSON if a path was set. Profiling
+    // stops here; later scopes and file reads are not recorded.
+    static void report();
+
+private:
+    struct Phase {
+        qint64 nsecs = 0;
+        int calls = 0;
+        int files = 0;
+        qint64 bytes = 0;
+    };
+
+    static bool enabled;
+    static QString jsonPath;
+    static QMutex mutex;
+    static QStringList order;
+    static QHash<QString, Phase> phases;
+    static int totalFiles;
+    static qint64 totalBytes;
+};
+
+#endif // STARTUPPROFILER_H
@@ -0,0 +1,109 @@
+#include "texturecache.h"
+#include "assetpack.h"
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <cstring>
+
+namespace {
+
+const char TEXTURE_CACHE_MAGIC[4] = { 'S', 'P', 'T', 'X' };
+
+struct TextureCacheHeader {
+    char magic[4];
+    quint32 version;
+    quint64 pathHash;
+    qint64 sourceModified;
+    qint64 sourceSize;
+    qint32 width;
+    qint32 height;
+    qint32 bytesPerLine;
+    qint32 format;
+    quint32 reserved[4];
+};
+
+// Called by QImage when the last copy of a mapped image goes away
+void releaseMapping(void* info)
+{
+    delete static_cast<QFile*>(info);
+}
+
+}
+
+bool TextureCache::enabled = true;
+
+QString TextureCache::cacheDirectory()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/textures";
+}
+
+QString TextureCache::entryPath(const QString& relativePath)
+{
+    return cacheDirectory() + "/" + QString::number(AssetPack::hashPath(relativePath), 16) + ".tex";
+}
+
+QImage TextureCache::load(const QString& relativePath, qint64 sourceModified, qint64 sourceSize)
+{
+    QFile* file = new QFile(entryPath(relativePath));
+    if (!file->open(QIODevice::ReadOnly) || file->size() < qint64(sizeof(TextureCacheHeader))) {
+        delete file;
+        return QImage();
+    }
+
+    const uchar* data = file->map(0, file->size());
+    if (!data) {
+        delete file;
+        return QImage();
+    }
+
+    TextureCacheHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    qint64 pixelBytes = qint64(header.bytesPerLine) * header.height;
+
+    if (std::memcmp(header.magic, TEXTURE_CACHE_MAGIC, sizeof(header.magic)) != 0
+        || header.version != TEXTURE_CACHE_VERSION
+        || header.pathHash != AssetPack::hashPath(relativePath)
+        || header.sourceModified != sourceModified
+        || header.sourceSize != sourceSize
+        || header.format != QImage::Format_ARGB32_Premultiplied
+        || qint64(sizeof(header)) + pixelBytes > file->size()) {
+        delete file;
+        return QImage();
+    }
+
+    // The image owns the mapping; it is released together with the last copy
+    return QImage(data + sizeof(header), header.width, header.height, header.bytesPerLine,
+                  QImage::Format_ARGB32_Premultiplied, releaseMapping, file);
+}
+
+QImage TextureCache::store(const QString& relativePath, qint64 sourceModified, qint64 sourceSize, const QImage& image)
+{
+    QImage converted = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+    TextureCacheHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, TEXTURE_CACHE_MAGIC, sizeof(header.magic));
+    header.version = TEXTURE_CACHE_VERSION;
+    header.pathHash = AssetPack::hashPath(relativePath);
+    header.sourceModified = sourceModified;
+    header.sourceSize = sourceSize;
+    header.width = converted.width();
+    header.height = converted.height();
+    header.bytesPerLine = qint32(converted.bytesPerLine());
+    header.format = QImage::Format_ARGB32_Premultiplied;
+
+    QDir().mkpath(cacheDirectory());
+
+    QSaveFile file(entryPath(relativePath));
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(converted.constBits()), converted.sizeInBytes());
+        if (!file.commit()) {
+            qDebug() << "TextureCache: Failed to write entry for" << relativePath;
+        }
+    }
+
+    return converted;
+}
\ No newline at end of file
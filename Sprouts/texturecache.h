@@ -0,0 +1,34 @@
+#ifndef TEXTURECACHE_H
+#define TEXTURECACHE_H
+
+#include <QImage>
+#include <QString>
+
+// Bump whenever the on-disk layout changes
+const quint32 TEXTURE_CACHE_VERSION = 1;
+
+// On-disk cache of decoded images, stored as premultiplied ARGB32 pixels behind
+// a small header. Entries are keyed by asset path and validated against the
+// source's modification time and size, so edited assets are re-decoded
+// automatically. Cached pixels are mapped and wrapped in a QImage without copying.
+// Safe to use from worker threads.
+class TextureCache
+{
+public:
+    static bool isEnabled() { return enabled; }
+    static void setEnabled(bool on) { enabled = on; }
+
+    // Null image if there is no up-to-date entry
+    static QImage load(const QString& relativePath, qint64 sourceModified, qint64 sourceSize);
+
+    // Store an image and return it in the cached pixel format
+    static QImage store(const QString& relativePath, qint64 sourceModified, qint64 sourceSize, const QImage& image);
+
+    static QString cacheDirectory();
+
+private:
+    static bool enabled;
+    static QString entryPath(const QString& relativePath);
+};
+
+#endif // TEXTURECACHE_H
@@ -0,0 +1,130 @@
+#include "timerwheel.h"
+#include <QtMath>
+
+TimerWheel::TimerWheel()
+    : buckets(WHEEL_SIZE, -1), tick(0), remainder(0.0f), pending(0)
+{
+}
+
+TimerHandle TimerWheel::schedule(int delayMs, std::function<void()> callback)
+{
+    int index;
+    if (!freeTimers.isEmpty()) {
+        index = freeTimers.takeLast();
+    } else {
+        index = timers.size();
+        timers.append(Timer());
+    }
+
+    // At least one tick, so a timer never fires in the advance() that scheduled it
+    quint64 ticks = qMax(1, (delayMs + TICK_MS - 1) / TICK_MS);
+
+    Timer& timer = timers[index];
+    timer.deadline = tick + ticks;
+    timer.callback = std::move(callback);
+    timer.scheduled = true;
+    link(index);
+    pending++;
+
+    TimerHandle handle;
+    handle.index = index;
+    handle.generation = timer.generation;
+    return handle;
+}
+
+void TimerWheel::cancel(TimerHandle handle)
+{
+    if (!isPending(handle)) {
+        return;
+    }
+    unlink(handle.index);
+    release(handle.index);
+}
+
+bool TimerWheel::isPending(TimerHandle handle) const
+{
+    if (handle.isNull() || handle.index >= quint32(timers.size())) {
+        return false;
+    }
+    const Timer& timer = timers[handle.index];
+    return timer.scheduled && timer.generation == handle.generation;
+}
+
+void TimerWheel::advance(float dt)
+{
+    remainder += dt * 1000.0f;
+    while (remainder >= TICK_MS) {
+        remainder -= TICK_MS;
+        tick++;
+        if (pending > 0) {
+            fireBucket(int(tick % WHEEL_SIZE));
+        }
+    }
+}
+
+void TimerWheel::fireBucket(int bucket)
+{
+    // Collect what is due first: callbacks may schedule or cancel timers
+    QVector<TimerHandle> due;
+    for (int index = buckets[bucket]; index != -1; index = timers[index].next) {
+        if (timers[index].deadline <= tick) {
+            TimerHandle handle;
+            handle.index = index;
+            handle.generation = timers[index].generation;
+            due.append(handle);
+        }
+    }
+
+    for (const TimerHandle& handle : due) {
+        if (!isPending(handle)) {
+            continue; // cancelled by an earlier callback
+        }
+        int index = handle.index;
+        std::function<void()> callback = std::move(timers[index].callback);
+        unlink(index);
+        release(index);
+        if (callback) {
+            callback();
+        }
+    }
+}
+
+void TimerWheel::link(int index)
+{
+    Timer& timer = timers[index];
+    int bucket = int(timer.deadline % WHEEL_SIZE);
+    timer.prev = -1;
+    timer.next = buckets[bucket];
+    if (timer.next != -1) {
+        timers[timer.next].prev = index;
+    }
+    buckets[bucket] = index;
+}
+
+void TimerWheel::unlink(int index)
+{
+    Timer& timer = timers[index];
+    if (timer.prev != -1) {
+        timers[timer.prev].next = timer.next;
+    } else {
+        buckets[int(timer.deadline % WHEEL_SIZE)] = timer.next;
+    }
+    if (timer.next != -1) {
+        timers[timer.next].prev = timer.prev;
+    }
+    timer.prev = -1;
+    timer.next = -1;
+}
+
+void TimerWheel::release(int index)
+{
+    Timer& timer = timers[index];
+    timer.scheduled = false;
+    timer.callback = nullptr;
+    timer.generation++;
+    if (timer.generation == 0) {
+        timer.generation = 1;
+    }
+    freeTimers.append(index);
+    pending--;
+}
\ No newline at end of file
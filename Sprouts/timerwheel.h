@@ -0,0 +1,67 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <QVector>
+#include <QtGlobal>
+#include <functional>
+
+// Handle to a timer scheduled on a TimerWheel. Stale once the timer fires or
+// is cancelled; a default constructed handle is null.
+struct TimerHandle
+{
+    quint32 index = 0;
+    quint32 generation = 0;
+
+    bool isNull() const { return generation == 0; }
+};
+
+// Hashed timing wheel driven by game time. Timers are bucketed by their
+// deadline tick, so scheduling and cancelling are O(1) and advancing costs
+// one bucket per elapsed tick. Callbacks fire from advance(), at tick
+// boundaries, so they stop whenever the owner stops advancing the wheel.
+class TimerWheel
+{
+public:
+    static const int TICK_MS = 10;
+    static const int WHEEL_SIZE = 256;
+
+    TimerWheel();
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    // Run callback after delayMs of game time (rounded up to whole ticks)
+    TimerHandle schedule(int delayMs, std::function<void()> callback = nullptr);
+    void cancel(TimerHandle handle);
+    bool isPending(TimerHandle handle) const;
+
+    // Advance game time by dt seconds, firing timers that come due
+    void advance(float dt);
+
+    quint64 currentTick() const { return tick; }
+    int pendingCount() const { return pending; }
+
+private:
+    struct Timer {
+        quint64 deadline = 0;
+        quint32 generation = 1;
+        int prev = -1;
+        int next = -1;
+        bool scheduled = false;
+        std::function<void()> callback;
+    };
+
+    void link(int index);
+    void unlink(int index);
+    void release(int index);
+    void fireBucket(int bucket);
+
+    QVector<Timer> timers;
+    QVector<int> freeTimers;
+    QVector<int> buckets; // head of each bucket's list, -1 when empty
+    quint64 tick;
+    float remainder;      // game time not yet turned into ticks, in ms
+    int pending;
+};
+
+#endif // TIMERWHEEL_H
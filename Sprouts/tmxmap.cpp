@@ -0,0 +1,426 @@
+#include "tmxmap.h"
+#include "mapcache.h"
+#include "resourceloader.h"
+#include "gamesettings.h"
+#include "startupprofiler.h"
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QStringList>
+#include <QXmlStreamReader>
+#include <QtEndian>
+#include <cstring>
+
+#ifdef SPROUTS_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef SPROUTS_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace {
+
+// Decompress a layer payload into exactly expectedSize bytes
+bool decompressLayer(const QByteArray& input, const QString& compression, int expectedSize, QByteArray& output)
+{
+    output = QByteArray(expectedSize, 0);
+
+    if (compression == QLatin1String("zlib") || compression == QLatin1String("gzip")) {
+#ifdef SPROUTS_HAVE_ZLIB
+        z_stream stream;
+        std::memset(&stream, 0, sizeof(stream));
+        // 15 + 32 lets inflate detect either a zlib or a gzip header
+        if (inflateInit2(&stream, 15 + 32) != Z_OK) {
+            return false;
+        }
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.constData()));
+        stream.avail_in = uInt(input.size());
+        stream.next_out = reinterpret_cast<Bytef*>(output.data());
+        stream.avail_out = uInt(output.size());
+        int result = inflate(&stream, Z_FINISH);
+        inflateEnd(&stream);
+        return result == Z_STREAM_END && stream.avail_out == 0;
+#else
+        if (compression == QLatin1String("gzip")) {
+            qDebug() << "TmxMap: gzip layers need Sprouts built with zlib";
+            return false;
+        }
+        // qUncompress expects the uncompressed size as a big-endian prefix
+        QByteArray prefixed(4, 0);
+        qToBigEndian(quint32(expectedSize), prefixed.data());
+        prefixed.append(input);
+        output = qUncompress(prefixed);
+        return output.size() == expectedSize;
+#endif
+    }
+
+    if (compression == QLatin1String("zstd")) {
+#ifdef SPROUTS_HAVE_ZSTD
+        size_t result = ZSTD_decompress(output.data(), size_t(output.size()), input.constData(), size_t(input.size()));
+        return !ZSTD_isError(result) && result == size_t(expectedSize);
+#else
+        qDebug() << "TmxMap: zstd layers need Sprouts built with libzstd";
+        return false;
+#endif
+    }
+
+    qDebug() << "TmxMap: Unknown layer compression" << compression;
+    return false;
+}
+
+}
+
+TmxMap::TmxMap()
+    : width(0), height(0), tileWidth(0), tileHeight(0), hasFarmableLayer(false)
+{
+}
+
+void TmxMap::clear()
+{
+    width = 0;
+    height = 0;
+    tileWidth = 0;
+    tileHeight = 0;
+    layers.clear();
+    objectGroups.clear();
+    tilesets.clear();
+    collisionMask.clear();
+    farmableMask.clear();
+    hasFarmableLayer = false;
+    sourceFiles.clear();
+    backingFile.reset();
+}
+
+bool TmxMap::load(const QString& relativePath)
+{
+    clear();
+
+    // Use the compiled cache when it is still up to date with its sources
+    {
+        StartupProfiler::Scope scope("TMX parse: cache");
+        if (MapCache::load(*this, relativePath)) {
+            return true;
+        }
+    }
+
+    {
+        StartupProfiler::Scope scope("TMX parse: xml " + relativePath);
+        if (!loadXml(relativePath)) {
+            return false;
+        }
+        buildMasks();
+    }
+
+    StartupProfiler::Scope scope("TMX parse: write cache");
+    MapCache::save(*this, relativePath);
+    return true;
+}
+
+bool TmxMap::loadXml(const QString& relativePath)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QString tmxFilePath = ResourceLoader::getResourcePath(relativePath);
+    QByteArray contents = ResourceLoader::readFile(relativePath);
+
+    if (contents.isEmpty()) {
+        qDebug() << "Failed to open TMX file:" << tmxFilePath;
+        return false;
+    }
+
+    // Tileset sources are relative to the directory of the map
+    QString mapDir = QFileInfo(relativePath).path();
+
+    sourceFiles.append(relativePath);
+
+    QXmlStreamReader xml(contents);
+    bool inObjectGroup = false;
+
+    while (!xml.atEnd() && !xml.hasError()) {
+        QXmlStreamReader::TokenType token = xml.readNext();
+
+        if (token == QXmlStreamReader::StartElement) {
+            QXmlStreamAttributes attributes = xml.attributes();
+
+            if (xml.name() == QLatin1String("map")) {
+                width = attributes.value("width").toInt();
+                height = attributes.value("height").toInt();
+                tileWidth = attributes.value("tilewidth").toInt();
+                tileHeight = attributes.value("tileheight").toInt();
+            }
+            else if (xml.name() == QLatin1String("tileset")) {
+                TmxTileset tileset;
+                tileset.firstGid = attributes.value("firstgid").toInt();
+                QString source = attributes.value("source").toString();
+                if (source.isEmpty()) {
+                    qDebug() << "TmxMap: Embedded tilesets are not supported, skipping firstgid" << tileset.firstGid;
+                    xml.skipCurrentElement();
+                    continue;
+                }
+                tileset.source = QDir::cleanPath(mapDir + "/" + source);
+                sourceFiles.append(tileset.source);
+                loadTileset(tileset);
+                tilesets.append(tileset);
+            }
+            else if (xml.name() == QLatin1String("layer")) {
+                TmxLayer layer;
+                layer.name = attributes.value("name").toString();
+                layer.width = attributes.value("width").toInt();
+                layer.height = attributes.value("height").toInt();
+                layer.visible = attributes.value("visible") != QLatin1String("0");
+
+                if (readLayerData(xml, layer)) {
+                    layers.append(layer);
+                }
+            }
+            else if (xml.name() == QLatin1String("objectgroup")) {
+                TmxObjectGroup group;
+                group.name = attributes.value("name").toString();
+                objectGroups.append(group);
+                inObjectGroup = true;
+            }
+            else if (xml.name() == QLatin1String("object") && inObjectGroup) {
+                TmxObject object;
+                object.id = attributes.value("id").toInt();
+                object.gid = attributes.value("gid").toInt();
+                object.name = attributes.value("name").toString();
+                object.type = attributes.value("type").toString();
+                object.bounds = QRectF(attributes.value("x").toDouble(),
+                                       attributes.value("y").toDouble(),
+                                       attributes.value("width").toDouble(),
+                                       attributes.value("height").toDouble());
+                objectGroups.last().objects.append(object);
+            }
+        }
+        else if (token == QXmlStreamReader::EndElement && xml.name() == QLatin1String("objectgroup")) {
+            inObjectGroup = false;
+        }
+    }
+
+    if (xml.hasError()) {
+        qDebug() << "TmxMap: XML error in" << tmxFilePath << ":" << xml.errorString();
+        return false;
+    }
+
+    qDebug() << "TmxMap: Loaded" << relativePath << width << "x" << height << "with"
+             << layers.size() << "layers," << objectGroups.size() << "object groups,"
+             << tilesets.size() << "tilesets in" << timer.elapsed() << "ms";
+    return true;
+}
+
+bool TmxMap::readLayerData(QXmlStreamReader& xml, TmxLayer& layer)
+{
+    // Find the data element for this layer
+    while (!xml.atEnd() && !(xml.isStartElement() && xml.name() == QLatin1String("data"))) {
+        xml.readNext();
+    }
+
+    if (!xml.isStartElement() || xml.name() != QLatin1String("data")) {
+        return false;
+    }
+
+    QXmlStreamAttributes attributes = xml.attributes();
+    QString encoding = attributes.value("encoding").toString();
+    QString compression = attributes.value("compression").toString();
+
+    layer.tiles = QByteArray(layer.width * layer.height * int(sizeof(quint16)), 0);
+
+    if (encoding == QLatin1String("csv")) {
+        return readCsvData(xml, layer);
+    }
+    if (encoding == QLatin1String("base64")) {
+        return readBase64Data(xml, layer, compression);
+    }
+
+    qDebug() << "TmxMap: Unsupported encoding" << encoding << "for layer" << layer.name;
+    xml.skipCurrentElement();
+    return false;
+}
+
+bool TmxMap::readCsvData(QXmlStreamReader& xml, TmxLayer& layer)
+{
+    int tileCount = layer.width * layer.height;
+    quint16* tiles = reinterpret_cast<quint16*>(layer.tiles.data());
+
+    // Decode the CSV in a single pass straight into the layer buffer.
+    // The text may arrive in several Characters chunks, so the number being
+    // accumulated carries over from one chunk to the next.
+    int index = 0;
+    quint64 value = 0;
+    bool inNumber = false;
+
+    auto storeValue = [&]() {
+        if (!inNumber) return;
+        if (value > 0xFFFF) {
+            qDebug() << "TmxMap: Tile id" << value << "in layer" << layer.name << "does not fit in 16 bits, dropping it";
+            value = 0;
+        }
+        if (index < tileCount) {
+            tiles[index] = static_cast<quint16>(value);
+        }
+        ++index;
+        value = 0;
+        inNumber = false;
+    };
+
+    while (!xml.atEnd()) {
+        QXmlStreamReader::TokenType token = xml.readNext();
+
+        if (token == QXmlStreamReader::Characters) {
+            for (QChar ch : xml.text()) {
+                ushort c = ch.unicode();
+                if (c >= '0' && c <= '9') {
+                    // Saturate instead of overflowing on malformed input
+                    if (value <= 0xFFFFFFFFu) {
+                        value = value * 10 + (c - '0');
+                    }
+                    inNumber = true;
+                } else {
+                    // Commas, newlines and indentation all end a value
+                    storeValue();
+                }
+            }
+        } else if (token == QXmlStreamReader::EndElement) {
+            break;
+        }
+    }
+    storeValue();
+
+    if (index != tileCount) {
+        qDebug() << "TmxMap: Layer" << layer.name << "has" << index << "tiles, expected" << tileCount;
+    }
+
+    return !xml.hasError();
+}
+
+bool TmxMap::readBase64Data(QXmlStreamReader& xml, TmxLayer& layer, const QString& compression)
+{
+    int tileCount = layer.width * layer.height;
+    QByteArray payload = QByteArray::fromBase64(xml.readElementText().toLatin1());
+
+    // Tiled stores each gid as a little-endian uint32
+    QByteArray gids;
+    if (compression.isEmpty()) {
+        gids = payload;
+    } else if (!decompressLayer(payload, compression, tileCount * 4, gids)) {
+        qDebug() << "TmxMap: Failed to decompress layer" << layer.name << "(" << compression << ")";
+        return false;
+    }
+
+    if (gids.size() != tileCount * 4) {
+        qDebug() << "TmxMap: Layer" << layer.name << "has" << gids.size() / 4 << "tiles, expected" << tileCount;
+        return false;
+    }
+
+    const uchar* source = reinterpret_cast<const uchar*>(gids.constData());
+    quint16* tiles = reinterpret_cast<quint16*>(layer.tiles.data());
+    for (int i = 0; i < tileCount; ++i) {
+        quint32 gid = qFromLittleEndian<quint32>(source + i * 4);
+        if (gid > 0xFFFF) {
+            qDebug() << "TmxMap: Tile id" << gid << "in layer" << layer.name << "does not fit in 16 bits, dropping it";
+            gid = 0;
+        }
+        tiles[i] = static_cast<quint16>(gid);
+    }
+
+    return true;
+}
+
+void TmxMap::buildMasks()
+{
+    int maskSize = (width * height + 7) / 8;
+    collisionMask = QByteArray(maskSize, 0);
+    farmableMask = QByteArray(maskSize, 0);
+
+    const TmxLayer* collisionLayer = layer("Collision");
+    const TmxLayer* fenceLayer = layer("Fence");
+    const TmxLayer* farmableLayer = layer("Farmable");
+    hasFarmableLayer = farmableLayer != nullptr;
+
+    auto tileIs = [](const TmxLayer* source, int x, int y, int tileId) {
+        if (!source || x >= source->width || y >= source->height) return false;
+        int tile = source->tileAt(x, y);
+        return tileId < 0 ? tile != 0 : tile == tileId;
+    };
+
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            int index = y * width + x;
+            if (tileIs(collisionLayer, x, y, COLLISION_TILE_ID) || tileIs(fenceLayer, x, y, -1)) {
+                collisionMask[index >> 3] = char(collisionMask[index >> 3] | (1 << (index & 7)));
+            }
+            if (tileIs(farmableLayer, x, y, FARMABLE_TILE_ID)) {
+                farmableMask[index >> 3] = char(farmableMask[index >> 3] | (1 << (index & 7)));
+            }
+        }
+    }
+}
+
+bool TmxMap::loadTileset(TmxTileset& tileset)
+{
+    StartupProfiler::Scope scope("TMX parse: " + tileset.source);
+
+    QByteArray contents = ResourceLoader::readFile(tileset.source);
+
+    if (contents.isEmpty()) {
+        qDebug() << "Failed to open TSX file:" << ResourceLoader::getResourcePath(tileset.source);
+        return false;
+    }
+
+    // Image sources are relative to the directory of the TSX file
+    QString tsxDir = QFileInfo(tileset.source).path();
+
+    QXmlStreamReader xml(contents);
+    int currentTileId = -1;
+
+    while (!xml.atEnd() && !xml.hasError()) {
+        xml.readNext();
+
+        if (!xml.isStartElement()) {
+            continue;
+        }
+
+        QXmlStreamAttributes attrs = xml.attributes();
+
+        if (xml.name() == QLatin1String("tileset")) {
+            tileset.columns = attrs.value("columns").toInt();
+        }
+        else if (xml.name() == QLatin1String("tile")) {
+            currentTileId = attrs.value("id").toInt();
+        }
+        else if (xml.name() == QLatin1String("image")) {
+            QString imagePath = QDir::cleanPath(tsxDir + "/" + attrs.value("source").toString());
+
+            if (tileset.columns == 0 && currentTileId >= 0) {
+                tileset.tileImages[currentTileId] = imagePath;
+            } else {
+                tileset.imageSource = imagePath;
+            }
+        }
+    }
+
+    return !xml.hasError();
+}
+
+const TmxLayer* TmxMap::layer(const QString& name) const
+{
+    for (const TmxLayer& layer : layers) {
+        if (layer.name == name) {
+            return &layer;
+        }
+    }
+    return nullptr;
+}
+
+const TmxObjectGroup* TmxMap::objectGroup(const QString& name) const
+{
+    for (const TmxObjectGroup& group : objectGroups) {
+        if (group.name == name) {
+            return &group;
+        }
+    }
+    return nullptr;
+}
@@ -0,0 +1,106 @@
+#ifndef TMXMAP_H
+#define TMXMAP_H
+
+#include <QVector>
+#include <QMap>
+#include <QRectF>
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QSharedPointer>
+
+class QFile;
+class QXmlStreamReader;
+
+// Tile layer: global tile ids packed as quint16, row-major.
+// The bytes are either owned (parsed from XML) or a view into the mapped map cache.
+struct TmxLayer {
+    QString name;
+    int width = 0;
+    int height = 0;
+    bool visible = true;
+    QByteArray tiles;
+
+    int tileAt(int x, int y) const { return reinterpret_cast<const quint16*>(tiles.constData())[y * width + x]; }
+};
+
+// Object inside an object group (bounds are in map pixels, as stored in the TMX)
+struct TmxObject {
+    int id = 0;
+    int gid = 0;
+    QString name;
+    QString type;
+    QRectF bounds;
+};
+
+struct TmxObjectGroup {
+    QString name;
+    QVector<TmxObject> objects;
+};
+
+// External tileset reference, resolved from its TSX file
+struct TmxTileset {
+    int firstGid = 0;
+    QString source;                 // TSX path relative to the resource root
+    int columns = 0;                // 0 means one image per tile
+    QString imageSource;            // Atlas image (columns > 0)
+    QMap<int, QString> tileImages;  // Local tile id -> image (columns == 0)
+};
+
+class TmxMap
+{
+public:
+    TmxMap();
+
+    // Parse the map and its tilesets once
+    bool load(const QString& relativePath);
+    void clear();
+    bool isLoaded() const { return width > 0 && height > 0; }
+
+    // Lookups
+    const TmxLayer* layer(const QString& name) const;
+    const TmxObjectGroup* objectGroup(const QString& name) const;
+
+    // Per-tile flags precomputed from the Collision/Fence and Farmable layers
+    bool isCollision(int x, int y) const { return testBit(collisionMask, y * width + x); }
+    bool isFarmable(int x, int y) const { return testBit(farmableMask, y * width + x); }
+    void buildMasks();
+
+    // Parse the TMX source only, bypassing the compiled cache (benchmarks)
+    bool loadXml(const QString& relativePath);
+
+    // Map dimensions
+    int width;
+    int height;
+    int tileWidth;
+    int tileHeight;
+
+    // Map contents
+    QVector<TmxLayer> layers;
+    QVector<TmxObjectGroup> objectGroups;
+    QVector<TmxTileset> tilesets;
+
+    // One bit per tile, row-major
+    QByteArray collisionMask;
+    QByteArray farmableMask;
+    bool hasFarmableLayer;
+
+    // Files the map was built from (map + TSX), relative to the resource root
+    QStringList sourceFiles;
+
+    // Keeps the mapped cache alive while layers reference it
+    QSharedPointer<QFile> backingFile;
+
+private:
+    bool readLayerData(QXmlStreamReader& xml, TmxLayer& layer);
+    bool readCsvData(QXmlStreamReader& xml, TmxLayer& layer);
+    bool readBase64Data(QXmlStreamReader& xml, TmxLayer& layer, const QString& compression);
+    bool loadTileset(TmxTileset& tileset);
+
+    static bool testBit(const QByteArray& mask, int index)
+    {
+        return (static_cast<uchar>(mask.constData()[index >> 3]) >> (index & 7)) & 1;
+    }
+};
+
+#endif // TMXMAP_H
@@ -1,13 +1,16 @@
 #include "tree.h"
 #include "resourceloader.h"
+#include "startupprofiler.h"
 #include <QRandomGenerator>
 #include <QDebug>
 
 Tree::Tree(const QPoint& pos, const QPixmap& surf, QVector<SpriteGroup*> groups, 
-           const QString& name, std::function<void(const QString&)> playerAdd, QObject *parent)
-    : Generic(pos, surf, groups), treeName(name), playerAdd(playerAdd), health(5), alive(true)
+           const QString& name, std::function<void(const QString&)> playerAdd,
+           EffectSystem* effects)
+    : Generic(pos, surf, groups), treeName(name), playerAdd(playerAdd), health(5), alive(true),
+      applePool("apples"), effects(effects)
 {
-    setParent(parent);
+    StartupProfiler::Scope scope("Tree construction");
     
     // Load stump surface
     QString stumpPath = QString("graphics/stumps/%1.png").arg(name == "Small" ? "small" : "large");
@@ -22,22 +25,33 @@ Tree::Tree(const QPoint& pos, const QPixmap& surf, QVector<SpriteGroup*> groups,
     }
     
     // Create apple sprite group
-    appleSprites = new SpriteGroup(this);
+    appleSprites = new SpriteGroup();
     
     // Create initial fruit
     createFruit();
     
     // Setup sound
-    axeSound = new QSoundEffect(this);
+    axeSound = new QSoundEffect();
     QString axePath = ResourceLoader::getResourcePath("audio/axe.wav");
     axeSound->setSource(QUrl::fromLocalFile(axePath));
     axeSound->setVolume(0.5);
 }
 
+Tree::~Tree()
+{
+    // Apples leave appleSprites as they are deleted, so the group must outlive them
+    applePool.clear();
+    delete appleSprites;
+    delete axeSound;
+}
+
 void Tree::damage()
 {
     // Damage the tree
     health--;
+    if (health <= 0 && alive) {
+        checkDeath();
+    }
     
     // Play sound
     if (axeSound) {
@@ -54,11 +68,7 @@ void Tree::damage()
         // Create particle effect
         if (randomApple) {
             // Create particle effect for apple drop
-            QVector<SpriteGroup*> particleGroups;
-            particleGroups.append(groups[0]); // Use the first group (usually allSprites)
-            Particle* particle = new Particle(randomApple->rect.topLeft(), randomApple->image, 
-                                             particleGroups, FRUIT);
-            particle->setParent(this->parent());
+            effects->flash(randomApple->rect.topLeft(), randomApple->image);
             
             playerAdd("apple");
             randomApple->kill();
@@ -70,7 +80,7 @@ void Tree::checkDeath()
 {
     if (health <= 0) {
         // Create particle effect for tree death
-        // Particle(rect.topLeft(), image, groups()[0], FRUIT, 300);
+        effects->flash(rect.topLeft(), image, 300);
         
         // Change to stump
         image = stumpSurf;
@@ -90,22 +100,15 @@ void Tree::checkDeath()
     }
 }
 
-void Tree::update(float dt)
-{
-    if (alive) {
-        checkDeath();
-    }
-    
-    // Update apple sprites
-    if (appleSprites) {
-        appleSprites->update(dt);
-    }
-}
-
 void Tree::createFruit()
 {
     if (!appleSprites) return;
     
+    // Yesterday's apples go back to the pool
+    for (Sprite* apple : appleSprites->sprites()) {
+        apple->kill();
+    }
+    
     for (const QPoint& pos : applePos) {
         // Random chance to create apple
         if (QRandomGenerator::global()->bounded(11) < 2) { // 20% chance
@@ -119,8 +122,7 @@ void Tree::createFruit()
                 appleGroups.append(groups[0]);
             }
             
-            Generic* apple = new Generic(appleWorldPos, appleSurf, appleGroups, FRUIT);
-            apple->setParent(this);
+            applePool.acquire(appleWorldPos, appleSurf, appleGroups, FRUIT);
         }
     }
 }
\ No newline at end of file
@@ -7,24 +7,23 @@
 #include <functional>
 #include "sprite.h"
 #include "spritegroup.h"
+#include "spritepool.h"
+#include "effectsystem.h"
 #include "gamesettings.h"
 
 class Tree : public Generic
 {
-    Q_OBJECT
-
 public:
     Tree(const QPoint& pos, const QPixmap& surf, QVector<SpriteGroup*> groups, 
-         const QString& name, std::function<void(const QString&)> playerAdd, QObject *parent = nullptr);
+         const QString& name, std::function<void(const QString&)> playerAdd,
+         EffectSystem* effects);
+    ~Tree() override;
     
     // Tree actions
     void damage();
     void checkDeath();
     void createFruit();
     
-    // Update
-    void update(float dt) override;
-    
     // Properties
     int health;
     bool alive;
@@ -40,6 +39,10 @@ private:
     QVector<QPoint> applePos;
     SpriteGroup* appleSprites;
     
+    // Apples are recycled every morning; knocked-off ones leave a flash
+    SpritePool<Generic> applePool;
+    EffectSystem* effects;
+    
     // Sound
     QSoundEffect* axeSound;
 };
@@ -0,0 +1,119 @@
+#include "triggersystem.h"
+#include "sprite.h"
+#include <QDebug>
+
+TriggerSystem::TriggerSystem(QObject *parent)
+    : QObject{parent}
+{
+}
+
+quint64 TriggerSystem::cellKey(int cellX, int cellY)
+{
+    return (static_cast<quint64>(static_cast<quint32>(cellX)) << 32) | static_cast<quint32>(cellY);
+}
+
+void TriggerSystem::addZone(Interaction* zone)
+{
+    if (!zone) return;
+
+    // Register the zone in every cell its rect overlaps
+    int minX = zone->rect.left() / TRIGGER_CELL_SIZE;
+    int maxX = zone->rect.right() / TRIGGER_CELL_SIZE;
+    int minY = zone->rect.top() / TRIGGER_CELL_SIZE;
+    int maxY = zone->rect.bottom() / TRIGGER_CELL_SIZE;
+
+    for (int cy = minY; cy <= maxY; ++cy) {
+        for (int cx = minX; cx <= maxX; ++cx) {
+            QVector<Interaction*>& bucket = cells[cellKey(cx, cy)];
+            if (!bucket.contains(zone)) {
+                bucket.append(zone);
+            }
+        }
+    }
+
+    // Force the next update to re-evaluate
+    lastBody = QRect();
+}
+
+void TriggerSystem::removeZone(Interaction* zone)
+{
+    if (!zone) return;
+
+    for (auto it = cells.begin(); it != cells.end(); ++it) {
+        it.value().removeOne(zone);
+    }
+
+    if (occupied.contains(zone)) {
+        exitZone(zone);
+    }
+}
+
+void TriggerSystem::update(const QRect& body)
+{
+    // Nothing to do if the body has not moved
+    if (body == lastBody) {
+        return;
+    }
+    lastBody = body;
+
+    // Collect zones overlapping the body from the cells it touches
+    QSet<Interaction*> inside;
+    int minX = body.left() / TRIGGER_CELL_SIZE;
+    int maxX = body.right() / TRIGGER_CELL_SIZE;
+    int minY = body.top() / TRIGGER_CELL_SIZE;
+    int maxY = body.bottom() / TRIGGER_CELL_SIZE;
+
+    for (int cy = minY; cy <= maxY; ++cy) {
+        for (int cx = minX; cx <= maxX; ++cx) {
+            auto it = cells.constFind(cellKey(cx, cy));
+            if (it == cells.constEnd()) continue;
+
+            for (Interaction* zone : it.value()) {
+                if (zone->rect.intersects(body)) {
+                    inside.insert(zone);
+                }
+            }
+        }
+    }
+
+    // Raise exit events for zones we left
+    const QSet<Interaction*> previous = occupied;
+    for (Interaction* zone : previous) {
+        if (!inside.contains(zone)) {
+            exitZone(zone);
+        }
+    }
+
+    // Raise enter events for zones we just entered
+    for (Interaction* zone : inside) {
+        if (!occupied.contains(zone)) {
+            enterZone(zone);
+        }
+    }
+}
+
+void TriggerSystem::enterZone(Interaction* zone)
+{
+    occupied.insert(zone);
+    if (!occupiedByName.contains(zone->name)) {
+        occupiedByName.insert(zone->name, zone);
+    }
+    emit zoneEntered(zone);
+}
+
+void TriggerSystem::exitZone(Interaction* zone)
+{
+    occupied.remove(zone);
+
+    // Hand the name over to another occupied zone with the same name, if any
+    if (occupiedByName.value(zone->name, nullptr) == zone) {
+        occupiedByName.remove(zone->name);
+        for (Interaction* other : occupied) {
+            if (other->name == zone->name) {
+                occupiedByName.insert(other->name, other);
+                break;
+            }
+        }
+    }
+    emit zoneExited(zone);
+}
@@ -0,0 +1,56 @@
+#ifndef TRIGGERSYSTEM_H
+#define TRIGGERSYSTEM_H
+
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QRect>
+#include <QVector>
+#include <QString>
+#include "gamesettings.h"
+
+class Interaction;
+
+// Cell size of the spatial hash used to bucket trigger zones
+const int TRIGGER_CELL_SIZE = TILE_SIZE * 4;
+
+class TriggerSystem : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TriggerSystem(QObject *parent = nullptr);
+
+    // Zone registration
+    void addZone(Interaction* zone);
+    void removeZone(Interaction* zone);
+
+    // Recompute the zones overlapped by the body and raise enter/exit events
+    void update(const QRect& body);
+
+    // Current zone set
+    const QSet<Interaction*>& currentZones() const { return occupied; }
+    bool isInside(Interaction* zone) const { return occupied.contains(zone); }
+    Interaction* zoneNamed(const QString& name) const { return occupiedByName.value(name, nullptr); }
+    bool empty() const { return occupied.isEmpty(); }
+
+signals:
+    void zoneEntered(Interaction* zone);
+    void zoneExited(Interaction* zone);
+
+private:
+    // Spatial hash: cell key -> zones overlapping that cell
+    QHash<quint64, QVector<Interaction*>> cells;
+
+    // Zones the body is currently inside
+    QSet<Interaction*> occupied;
+    QHash<QString, Interaction*> occupiedByName;
+
+    QRect lastBody;
+
+    static quint64 cellKey(int cellX, int cellY);
+    void enterZone(Interaction* zone);
+    void exitZone(Interaction* zone);
+};
+
+#endif // TRIGGERSYSTEM_H